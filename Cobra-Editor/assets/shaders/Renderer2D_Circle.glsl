@@ -6,12 +6,18 @@
 #type vertex
 #version 450 core
 			
-layout(location = 0) in vec3 a_WorldPosition;
-layout(location = 1) in vec3 a_LocalPosition;
-layout(location = 2) in vec4 a_Color;
-layout(location = 3) in float a_Thickness;
-layout(location = 4) in float a_Fade;
-layout(location = 5) in int a_EntityID;
+// Per-vertex (shared unit quad)
+layout(location = 0) in vec2 a_LocalPosition;
+
+// Per-instance
+layout(location = 1) in vec3 a_Position;
+layout(location = 2) in vec3 a_AxisX;
+layout(location = 3) in vec3 a_AxisY;
+layout(location = 4) in vec4 a_Color;          // RGBA8
+layout(location = 5) in vec2 a_ThicknessFade;  // half2
+#ifdef ENTITY_ID
+layout(location = 6) in int a_EntityID;
+#endif
 
 layout(std140, binding = 0) uniform Camera
 {
@@ -27,24 +33,32 @@ struct VertexOutput
 };
 
 layout(location = 0) out VertexOutput Output;
+#ifdef ENTITY_ID
 layout(location = 4) out flat int v_EntityID;
+#endif
 
 void main()
 {
-	Output.LocalPosition = a_LocalPosition;
+	vec3 position = a_Position + a_LocalPosition.x * a_AxisX + a_LocalPosition.y * a_AxisY;
+
+	Output.LocalPosition = vec3(a_LocalPosition * 2.0, 0.0);
 	Output.Color = a_Color;
-	Output.Thickness = a_Thickness;
-	Output.Fade = a_Fade;
+	Output.Thickness = a_ThicknessFade.x;
+	Output.Fade = a_ThicknessFade.y;
+#ifdef ENTITY_ID
 	v_EntityID = a_EntityID;
+#endif
 
-	gl_Position = u_ViewProjection * vec4(a_WorldPosition, 1.0);
+	gl_Position = u_ViewProjection * vec4(position, 1.0);
 }
 
 #type fragment
 #version 450
 			
 layout(location = 0) out vec4 o_Color;
+#ifdef ENTITY_ID
 layout(location = 1) out int o_EntityID;
+#endif
 
 struct VertexOutput
 {
@@ -55,7 +69,9 @@ struct VertexOutput
 };
 
 layout(location = 0) in VertexOutput Input;
+#ifdef ENTITY_ID
 layout(location = 4) in flat int v_EntityID;
+#endif
 
 void main()
 { 
@@ -71,5 +87,7 @@ void main()
     o_Color = Input.Color;
     o_Color.a *= circle;
 
+#ifdef ENTITY_ID
 	o_EntityID = v_EntityID;
+#endif
 }
\ No newline at end of file
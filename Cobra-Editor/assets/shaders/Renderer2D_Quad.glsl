@@ -2,103 +2,253 @@
 
 #type vertex
 #version 450 core
-			
-layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec4 a_Color;
-layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in float a_TexIndex;
-layout(location = 4) in float a_TilingFactor;
-layout(location = 5) in int a_EntityID;
+
+// Per-vertex (shared unit quad)
+layout(location = 0) in vec2 a_LocalPosition;
+
+// Per-instance
+layout(location = 1) in vec3 a_Position;
+layout(location = 2) in vec3 a_AxisX;
+layout(location = 3) in vec3 a_AxisY;
+layout(location = 4) in vec4 a_Color;        // RGBA8
+layout(location = 5) in vec4 a_TexRect;      // unorm16 uv min, uv max
+layout(location = 6) in float a_TilingFactor; // half, line width in pixels for lines
+layout(location = 7) in float a_TexIndex;     // uint8
+layout(location = 8) in float a_Flags;        // uint8
+#ifdef ENTITY_ID
+layout(location = 9) in int a_EntityID;
+#endif
 
 layout(std140, binding = 0) uniform Camera
 {
 	mat4 u_ViewProjection;
+	vec2 u_ViewportSize;
 };
 
+const int QuadInstanceLine = 1;
+const int QuadInstanceCircle = 2;
+
 struct VertexOutput
 {
 	vec4 Color;
 	vec2 TexCoord;
-	float TilingFactor;
 };
 
 layout(location = 0) out VertexOutput Output;
-layout(location = 3) out flat float v_TexIndex;
-layout(location = 4) out flat int v_EntityID;
+layout(location = 2) out flat float v_TexIndex;
+#ifdef ENTITY_ID
+layout(location = 3) out flat int v_EntityID;
+#endif
+#ifdef UNIFIED
+layout(location = 4) out flat float v_Flags;
+layout(location = 5) out vec2 v_LocalPosition;
+#endif
+
+// Lines run from a_Position to a_Position + a_AxisX and are widened perpendicular to their screen space direction
+vec4 expandLine()
+{
+	vec4 start = u_ViewProjection * vec4(a_Position, 1.0);
+	vec4 end = u_ViewProjection * vec4(a_Position + a_AxisX, 1.0);
+
+	vec2 direction = (end.xy / end.w - start.xy / start.w) * u_ViewportSize;
+	direction = length(direction) > 0.0 ? normalize(direction) : vec2(1.0, 0.0);
+
+	vec4 position = mix(start, end, a_LocalPosition.x + 0.5);
+	position.xy += vec2(-direction.y, direction.x) * a_TilingFactor * a_LocalPosition.y * 2.0 / u_ViewportSize * position.w;
+	return position;
+}
 
 void main()
 {
+	bool isLine = (int(a_Flags) & QuadInstanceLine) != 0;
+
 	Output.Color = a_Color;
-	Output.TexCoord = a_TexCoord;
-	Output.TilingFactor = a_TilingFactor;
+	Output.TexCoord = isLine ? vec2(0.0) : mix(a_TexRect.xy, a_TexRect.zw, a_LocalPosition + 0.5) * a_TilingFactor;
 	v_TexIndex = a_TexIndex;
+#ifdef ENTITY_ID
 	v_EntityID = a_EntityID;
+#endif
+#ifdef UNIFIED
+	v_Flags = a_Flags;
+	v_LocalPosition = a_LocalPosition * 2.0;
+
+	// Circles keep thickness and fade in the texture rect
+	if ((int(a_Flags) & QuadInstanceCircle) != 0)
+		Output.TexCoord = a_TexRect.xy;
+#endif
 
-	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
+	if (isLine)
+	{
+		gl_Position = expandLine();
+	}
+	else
+	{
+		vec3 position = a_Position + a_LocalPosition.x * a_AxisX + a_LocalPosition.y * a_AxisY;
+		gl_Position = u_ViewProjection * vec4(position, 1.0);
+	}
 }
 
 #type fragment
 #version 450
 			
 layout(location = 0) out vec4 o_Color;
+#ifdef ENTITY_ID
 layout(location = 1) out int o_EntityID;
+#endif
 
 struct VertexOutput
 {
 	vec4 Color;
 	vec2 TexCoord;
-	float TilingFactor;
 };
 
 layout(location = 0) in VertexOutput Input;
-layout(location = 3) in flat float v_TexIndex;
-layout(location = 4) in flat int v_EntityID;
+layout(location = 2) in flat float v_TexIndex;
+#ifdef ENTITY_ID
+layout(location = 3) in flat int v_EntityID;
+#endif
+#ifdef UNIFIED
+layout(location = 4) in flat float v_Flags;
+layout(location = 5) in vec2 v_LocalPosition;
+#endif
 
 layout(binding = 0) uniform sampler2D u_Textures[32];
 
-void main()
+vec4 sampleTexture()
 {
-	vec4 texColor = Input.Color;
+	switch(int(v_TexIndex))
+	{
+		case 0: return texture(u_Textures[0], Input.TexCoord);
+		case 1: return texture(u_Textures[1], Input.TexCoord);
+		case 2: return texture(u_Textures[2], Input.TexCoord);
+		case 3: return texture(u_Textures[3], Input.TexCoord);
+		case 4: return texture(u_Textures[4], Input.TexCoord);
+		case 5: return texture(u_Textures[5], Input.TexCoord);
+		case 6: return texture(u_Textures[6], Input.TexCoord);
+		case 7: return texture(u_Textures[7], Input.TexCoord);
+		case 8: return texture(u_Textures[8], Input.TexCoord);
+		case 9: return texture(u_Textures[9], Input.TexCoord);
+		case 10: return texture(u_Textures[10], Input.TexCoord);
+		case 11: return texture(u_Textures[11], Input.TexCoord);
+		case 12: return texture(u_Textures[12], Input.TexCoord);
+		case 13: return texture(u_Textures[13], Input.TexCoord);
+		case 14: return texture(u_Textures[14], Input.TexCoord);
+		case 15: return texture(u_Textures[15], Input.TexCoord);
+		case 16: return texture(u_Textures[16], Input.TexCoord);
+		case 17: return texture(u_Textures[17], Input.TexCoord);
+		case 18: return texture(u_Textures[18], Input.TexCoord);
+		case 19: return texture(u_Textures[19], Input.TexCoord);
+		case 20: return texture(u_Textures[20], Input.TexCoord);
+		case 21: return texture(u_Textures[21], Input.TexCoord);
+		case 22: return texture(u_Textures[22], Input.TexCoord);
+		case 23: return texture(u_Textures[23], Input.TexCoord);
+		case 24: return texture(u_Textures[24], Input.TexCoord);
+		case 25: return texture(u_Textures[25], Input.TexCoord);
+		case 26: return texture(u_Textures[26], Input.TexCoord);
+		case 27: return texture(u_Textures[27], Input.TexCoord);
+		case 28: return texture(u_Textures[28], Input.TexCoord);
+		case 29: return texture(u_Textures[29], Input.TexCoord);
+		case 30: return texture(u_Textures[30], Input.TexCoord);
+		case 31: return texture(u_Textures[31], Input.TexCoord);
+	}
+
+	return vec4(1.0);
+}
+
+#ifdef UNIFIED
+const int QuadInstanceCircle = 2;
+const int QuadInstanceText = 4;
 
+vec2 getTextureSize()
+{
 	switch(int(v_TexIndex))
 	{
-		case 0: texColor *= texture(u_Textures[0], Input.TexCoord * Input.TilingFactor); break;
-		case 1: texColor *= texture(u_Textures[1], Input.TexCoord * Input.TilingFactor); break;
-		case 2: texColor *= texture(u_Textures[2], Input.TexCoord * Input.TilingFactor); break;
-		case 3: texColor *= texture(u_Textures[3], Input.TexCoord * Input.TilingFactor); break;
-		case 4: texColor *= texture(u_Textures[4], Input.TexCoord * Input.TilingFactor); break;
-		case 5: texColor *= texture(u_Textures[5], Input.TexCoord * Input.TilingFactor); break;
-		case 6: texColor *= texture(u_Textures[6], Input.TexCoord * Input.TilingFactor); break;
-		case 7: texColor *= texture(u_Textures[7], Input.TexCoord * Input.TilingFactor); break;
-		case 8: texColor *= texture(u_Textures[8], Input.TexCoord * Input.TilingFactor); break;
-		case 9: texColor *= texture(u_Textures[9], Input.TexCoord * Input.TilingFactor); break;
-		case 10: texColor *= texture(u_Textures[10], Input.TexCoord * Input.TilingFactor); break;
-		case 11: texColor *= texture(u_Textures[11], Input.TexCoord * Input.TilingFactor); break;
-		case 12: texColor *= texture(u_Textures[12], Input.TexCoord * Input.TilingFactor); break;
-		case 13: texColor *= texture(u_Textures[13], Input.TexCoord * Input.TilingFactor); break;
-		case 14: texColor *= texture(u_Textures[14], Input.TexCoord * Input.TilingFactor); break;
-		case 15: texColor *= texture(u_Textures[15], Input.TexCoord * Input.TilingFactor); break;
-		case 16: texColor *= texture(u_Textures[16], Input.TexCoord * Input.TilingFactor); break;
-		case 17: texColor *= texture(u_Textures[17], Input.TexCoord * Input.TilingFactor); break;
-		case 18: texColor *= texture(u_Textures[18], Input.TexCoord * Input.TilingFactor); break;
-		case 19: texColor *= texture(u_Textures[19], Input.TexCoord * Input.TilingFactor); break;
-		case 20: texColor *= texture(u_Textures[20], Input.TexCoord * Input.TilingFactor); break;
-		case 21: texColor *= texture(u_Textures[21], Input.TexCoord * Input.TilingFactor); break;
-		case 22: texColor *= texture(u_Textures[22], Input.TexCoord * Input.TilingFactor); break;
-		case 23: texColor *= texture(u_Textures[23], Input.TexCoord * Input.TilingFactor); break;
-		case 24: texColor *= texture(u_Textures[24], Input.TexCoord * Input.TilingFactor); break;
-		case 25: texColor *= texture(u_Textures[25], Input.TexCoord * Input.TilingFactor); break;
-		case 26: texColor *= texture(u_Textures[26], Input.TexCoord * Input.TilingFactor); break;
-		case 27: texColor *= texture(u_Textures[27], Input.TexCoord * Input.TilingFactor); break;
-		case 28: texColor *= texture(u_Textures[28], Input.TexCoord * Input.TilingFactor); break;
-		case 29: texColor *= texture(u_Textures[29], Input.TexCoord * Input.TilingFactor); break;
-		case 30: texColor *= texture(u_Textures[30], Input.TexCoord * Input.TilingFactor); break;
-		case 31: texColor *= texture(u_Textures[31], Input.TexCoord * Input.TilingFactor); break;
+		case 0: return vec2(textureSize(u_Textures[0], 0));
+		case 1: return vec2(textureSize(u_Textures[1], 0));
+		case 2: return vec2(textureSize(u_Textures[2], 0));
+		case 3: return vec2(textureSize(u_Textures[3], 0));
+		case 4: return vec2(textureSize(u_Textures[4], 0));
+		case 5: return vec2(textureSize(u_Textures[5], 0));
+		case 6: return vec2(textureSize(u_Textures[6], 0));
+		case 7: return vec2(textureSize(u_Textures[7], 0));
+		case 8: return vec2(textureSize(u_Textures[8], 0));
+		case 9: return vec2(textureSize(u_Textures[9], 0));
+		case 10: return vec2(textureSize(u_Textures[10], 0));
+		case 11: return vec2(textureSize(u_Textures[11], 0));
+		case 12: return vec2(textureSize(u_Textures[12], 0));
+		case 13: return vec2(textureSize(u_Textures[13], 0));
+		case 14: return vec2(textureSize(u_Textures[14], 0));
+		case 15: return vec2(textureSize(u_Textures[15], 0));
+		case 16: return vec2(textureSize(u_Textures[16], 0));
+		case 17: return vec2(textureSize(u_Textures[17], 0));
+		case 18: return vec2(textureSize(u_Textures[18], 0));
+		case 19: return vec2(textureSize(u_Textures[19], 0));
+		case 20: return vec2(textureSize(u_Textures[20], 0));
+		case 21: return vec2(textureSize(u_Textures[21], 0));
+		case 22: return vec2(textureSize(u_Textures[22], 0));
+		case 23: return vec2(textureSize(u_Textures[23], 0));
+		case 24: return vec2(textureSize(u_Textures[24], 0));
+		case 25: return vec2(textureSize(u_Textures[25], 0));
+		case 26: return vec2(textureSize(u_Textures[26], 0));
+		case 27: return vec2(textureSize(u_Textures[27], 0));
+		case 28: return vec2(textureSize(u_Textures[28], 0));
+		case 29: return vec2(textureSize(u_Textures[29], 0));
+		case 30: return vec2(textureSize(u_Textures[30], 0));
+		case 31: return vec2(textureSize(u_Textures[31], 0));
 	}
 
+	return vec2(1.0);
+}
+
+float circleCoverage()
+{
+	float thickness = Input.TexCoord.x;
+	float fade = Input.TexCoord.y;
+
+	float distance = 1.0 - length(v_LocalPosition);
+	float circle = smoothstep(0.0, fade, distance);
+	return circle * smoothstep(thickness + fade, thickness, distance);
+}
+
+float median(float r, float g, float b)
+{
+	return max(min(r, g), min(max(r, g), b));
+}
+
+float textCoverage()
+{
+	const float pxRange = 2.0; // set to distance field's pixel range
+	vec2 unitRange = vec2(pxRange) / getTextureSize();
+	vec2 screenTexSize = vec2(1.0) / fwidth(Input.TexCoord);
+	float screenPxRange = max(0.5 * dot(unitRange, screenTexSize), 1.0);
+
+	vec3 msd = sampleTexture().rgb;
+	float sd = median(msd.r, msd.g, msd.b);
+	return clamp(screenPxRange * (sd - 0.5) + 0.5, 0.0, 1.0);
+}
+#endif
+
+void main()
+{
+	vec4 texColor = Input.Color;
+
+#ifdef UNIFIED
+	int flags = int(v_Flags);
+	if ((flags & QuadInstanceCircle) != 0)
+		texColor.a *= circleCoverage();
+	else if ((flags & QuadInstanceText) != 0)
+		texColor.a *= textCoverage();
+	else
+		texColor *= sampleTexture();
+#else
+	texColor *= sampleTexture();
+#endif
+
 	if (texColor.a == 0.0)
 		discard;
 
 	o_Color = texColor;
+#ifdef ENTITY_ID
 	o_EntityID = v_EntityID;
+#endif
 }
\ No newline at end of file
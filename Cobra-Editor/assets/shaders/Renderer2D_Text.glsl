@@ -4,9 +4,12 @@
 #version 450 core
 			
 layout(location = 0) in vec3 a_Position;
-layout(location = 1) in vec4 a_Color;
-layout(location = 2) in vec2 a_TexCoord;
-layout(location = 3) in int a_EntityID;
+layout(location = 1) in vec4 a_Color;    // RGBA8
+layout(location = 2) in vec2 a_TexCoord; // unorm16
+layout(location = 3) in float a_TexIndex; // uint8
+#ifdef ENTITY_ID
+layout(location = 4) in int a_EntityID;
+#endif
 
 layout(std140, binding = 0) uniform Camera
 {
@@ -20,13 +23,19 @@ struct VertexOutput
 };
 
 layout(location = 0) out VertexOutput Output;
-layout(location = 2) out flat int v_EntityID;
+layout(location = 2) out flat float v_TexIndex;
+#ifdef ENTITY_ID
+layout(location = 3) out flat int v_EntityID;
+#endif
 
 void main()
 {
 	Output.Color = a_Color;
 	Output.TexCoord = a_TexCoord;
+	v_TexIndex = a_TexIndex;
+#ifdef ENTITY_ID
 	v_EntityID = a_EntityID;
+#endif
 
 	gl_Position = u_ViewProjection * vec4(a_Position, 1.0);
 }
@@ -35,7 +44,9 @@ void main()
 #version 450 core
 			
 layout(location = 0) out vec4 o_Color;
+#ifdef ENTITY_ID
 layout(location = 1) out int o_EntityID;
+#endif
 
 struct VertexOutput
 {
@@ -44,14 +55,60 @@ struct VertexOutput
 };
 
 layout(location = 0) in VertexOutput Input;
-layout(location = 2) in flat int v_EntityID;
+layout(location = 2) in flat float v_TexIndex;
+#ifdef ENTITY_ID
+layout(location = 3) in flat int v_EntityID;
+#endif
 
-layout(binding = 0) uniform sampler2D u_FontAtlas;
+// Font atlases share the texture slots with sprites
+layout(binding = 0) uniform sampler2D u_FontAtlases[32];
 
-float screenPxRange()
+vec3 sampleFontAtlas(out vec2 atlasSize)
+{
+	switch(int(v_TexIndex))
+	{
+		case 0: atlasSize = vec2(textureSize(u_FontAtlases[0], 0)); return texture(u_FontAtlases[0], Input.TexCoord).rgb;
+		case 1: atlasSize = vec2(textureSize(u_FontAtlases[1], 0)); return texture(u_FontAtlases[1], Input.TexCoord).rgb;
+		case 2: atlasSize = vec2(textureSize(u_FontAtlases[2], 0)); return texture(u_FontAtlases[2], Input.TexCoord).rgb;
+		case 3: atlasSize = vec2(textureSize(u_FontAtlases[3], 0)); return texture(u_FontAtlases[3], Input.TexCoord).rgb;
+		case 4: atlasSize = vec2(textureSize(u_FontAtlases[4], 0)); return texture(u_FontAtlases[4], Input.TexCoord).rgb;
+		case 5: atlasSize = vec2(textureSize(u_FontAtlases[5], 0)); return texture(u_FontAtlases[5], Input.TexCoord).rgb;
+		case 6: atlasSize = vec2(textureSize(u_FontAtlases[6], 0)); return texture(u_FontAtlases[6], Input.TexCoord).rgb;
+		case 7: atlasSize = vec2(textureSize(u_FontAtlases[7], 0)); return texture(u_FontAtlases[7], Input.TexCoord).rgb;
+		case 8: atlasSize = vec2(textureSize(u_FontAtlases[8], 0)); return texture(u_FontAtlases[8], Input.TexCoord).rgb;
+		case 9: atlasSize = vec2(textureSize(u_FontAtlases[9], 0)); return texture(u_FontAtlases[9], Input.TexCoord).rgb;
+		case 10: atlasSize = vec2(textureSize(u_FontAtlases[10], 0)); return texture(u_FontAtlases[10], Input.TexCoord).rgb;
+		case 11: atlasSize = vec2(textureSize(u_FontAtlases[11], 0)); return texture(u_FontAtlases[11], Input.TexCoord).rgb;
+		case 12: atlasSize = vec2(textureSize(u_FontAtlases[12], 0)); return texture(u_FontAtlases[12], Input.TexCoord).rgb;
+		case 13: atlasSize = vec2(textureSize(u_FontAtlases[13], 0)); return texture(u_FontAtlases[13], Input.TexCoord).rgb;
+		case 14: atlasSize = vec2(textureSize(u_FontAtlases[14], 0)); return texture(u_FontAtlases[14], Input.TexCoord).rgb;
+		case 15: atlasSize = vec2(textureSize(u_FontAtlases[15], 0)); return texture(u_FontAtlases[15], Input.TexCoord).rgb;
+		case 16: atlasSize = vec2(textureSize(u_FontAtlases[16], 0)); return texture(u_FontAtlases[16], Input.TexCoord).rgb;
+		case 17: atlasSize = vec2(textureSize(u_FontAtlases[17], 0)); return texture(u_FontAtlases[17], Input.TexCoord).rgb;
+		case 18: atlasSize = vec2(textureSize(u_FontAtlases[18], 0)); return texture(u_FontAtlases[18], Input.TexCoord).rgb;
+		case 19: atlasSize = vec2(textureSize(u_FontAtlases[19], 0)); return texture(u_FontAtlases[19], Input.TexCoord).rgb;
+		case 20: atlasSize = vec2(textureSize(u_FontAtlases[20], 0)); return texture(u_FontAtlases[20], Input.TexCoord).rgb;
+		case 21: atlasSize = vec2(textureSize(u_FontAtlases[21], 0)); return texture(u_FontAtlases[21], Input.TexCoord).rgb;
+		case 22: atlasSize = vec2(textureSize(u_FontAtlases[22], 0)); return texture(u_FontAtlases[22], Input.TexCoord).rgb;
+		case 23: atlasSize = vec2(textureSize(u_FontAtlases[23], 0)); return texture(u_FontAtlases[23], Input.TexCoord).rgb;
+		case 24: atlasSize = vec2(textureSize(u_FontAtlases[24], 0)); return texture(u_FontAtlases[24], Input.TexCoord).rgb;
+		case 25: atlasSize = vec2(textureSize(u_FontAtlases[25], 0)); return texture(u_FontAtlases[25], Input.TexCoord).rgb;
+		case 26: atlasSize = vec2(textureSize(u_FontAtlases[26], 0)); return texture(u_FontAtlases[26], Input.TexCoord).rgb;
+		case 27: atlasSize = vec2(textureSize(u_FontAtlases[27], 0)); return texture(u_FontAtlases[27], Input.TexCoord).rgb;
+		case 28: atlasSize = vec2(textureSize(u_FontAtlases[28], 0)); return texture(u_FontAtlases[28], Input.TexCoord).rgb;
+		case 29: atlasSize = vec2(textureSize(u_FontAtlases[29], 0)); return texture(u_FontAtlases[29], Input.TexCoord).rgb;
+		case 30: atlasSize = vec2(textureSize(u_FontAtlases[30], 0)); return texture(u_FontAtlases[30], Input.TexCoord).rgb;
+		case 31: atlasSize = vec2(textureSize(u_FontAtlases[31], 0)); return texture(u_FontAtlases[31], Input.TexCoord).rgb;
+	}
+
+	atlasSize = vec2(1.0);
+	return vec3(0.0);
+}
+
+float screenPxRange(vec2 atlasSize)
 {
 	const float pxRange = 2.0; // set to distance field's pixel range
-    vec2 unitRange = vec2(pxRange)/vec2(textureSize(u_FontAtlas, 0));
+    vec2 unitRange = vec2(pxRange)/atlasSize;
     vec2 screenTexSize = vec2(1.0)/fwidth(Input.TexCoord);
     return max(0.5*dot(unitRange, screenTexSize), 1.0);
 }
@@ -63,11 +120,10 @@ float median(float r, float g, float b)
 
 void main()
 {
-	vec4 texColor = Input.Color * texture(u_FontAtlas, Input.TexCoord);
-
-	vec3 msd = texture(u_FontAtlas, Input.TexCoord).rgb;
+	vec2 atlasSize;
+	vec3 msd = sampleFontAtlas(atlasSize);
     float sd = median(msd.r, msd.g, msd.b);
-    float screenPxDistance = screenPxRange()*(sd - 0.5);
+    float screenPxDistance = screenPxRange(atlasSize)*(sd - 0.5);
     float opacity = clamp(screenPxDistance + 0.5, 0.0, 1.0);
 
 	if (opacity == 0.0)
@@ -75,5 +131,7 @@ void main()
 
 	vec4 bgColor = vec4(0.0);
     o_Color = mix(bgColor, Input.Color, opacity);
+#ifdef ENTITY_ID
 	o_EntityID = v_EntityID;
+#endif
 }
\ No newline at end of file
@@ -98,6 +98,7 @@ namespace Cobra {
 
 		// Render
 		Renderer2D::ResetStats();
+		RenderCommand::ResetStateStatistics();
 
 		m_Framebuffer->Bind();
 		RenderCommand::SetClearColor({ 0.1f, 0.1f, 0.1f, 1 });
@@ -142,9 +143,16 @@ namespace Cobra {
 		ScriptGlue::SetEditorViewportSize(viewportSize);
 		if (mouseX >= 0 && mouseY >= 0 && mouseX < (int)viewportSize.x && mouseY < (int)viewportSize.y)
 		{
-			int pixelData = m_Framebuffer->ReadPixel(1, mouseX, mouseY);
+			m_Framebuffer->RequestPixel(1, mouseX, mouseY);
 			ScriptGlue::SetEditorViewportCursorPos({ mouseX, mouseY });
-			m_HoveredEntity = (pixelData == -1) ? Entity() : Entity((entt::entity)pixelData, m_ActiveScene.get());
+		}
+
+		// The result lags a frame or two behind, by which time the entity may have been destroyed
+		int pixelData;
+		if (m_Framebuffer->PollPixel(pixelData))
+		{
+			bool valid = pixelData != -1 && m_ActiveScene->IsEntityValid((entt::entity)pixelData);
+			m_HoveredEntity = valid ? Entity((entt::entity)pixelData, m_ActiveScene.get()) : Entity();
 		}
 
 		OnOverlayRender();
@@ -220,9 +228,13 @@ namespace Cobra {
 		ImGui::Text("Renderer2D Stats:");
 		ImGui::Text("Draw Calls: %d", stats.DrawCalls);
 		ImGui::Text("Quads: %d", stats.QuadCount);
+		ImGui::Text("Culled: %d", stats.CulledCount);
 		ImGui::Text("Vertices: %d", stats.GetTotalVertexCount());
 		ImGui::Text("Indices: %d", stats.GetTotalIndexCount());
 
+		auto stateStats = RenderCommand::GetStateStatistics();
+		ImGui::Text("State Changes: %d (%d elided)", stateStats.Issued, stateStats.Elided);
+
 		ImGui::End();
 
 		ImGui::Begin("Settings");
@@ -547,6 +547,7 @@ namespace Cobra {
 			ImGui::Text("Texture");
 
 			ImGui::DragFloat("Tiling Factor", &component.TilingFactor, 0.1f, 0.0f, 100.0f);
+			ImGui::Checkbox("Static", &component.Static);
 		});
 
 		DrawComponent<CircleRendererComponent>("Circle Renderer", entity, [](CircleRendererComponent& component)
@@ -6,11 +6,27 @@
 
 namespace Cobra {
 
+	enum class TextureCompression
+	{
+		None = 0,
+		BC1, // RGB, alpha is dropped
+		BC3,
+		BC7
+	};
+
+	struct TextureImportSettings
+	{
+		bool GenerateMips = true;
+		TextureCompression Compression = TextureCompression::None; // Encoded on the CPU when the texture is imported
+	};
+
 	struct AssetMetadata
 	{
 		AssetType Type = AssetType::None;
 		std::filesystem::path FilePath;
 
+		TextureImportSettings TextureSettings; // Texture2D only
+
 		operator bool() const { return Type != AssetType::None; }
 	};
 
@@ -15,6 +15,28 @@ namespace Cobra {
 		{ ".jpeg", AssetType::Texture2D }
 	};
 
+	static std::string_view TextureCompressionToString(TextureCompression compression)
+	{
+		switch (compression)
+		{
+			case TextureCompression::None: return "None";
+			case TextureCompression::BC1:  return "BC1";
+			case TextureCompression::BC3:  return "BC3";
+			case TextureCompression::BC7:  return "BC7";
+		}
+
+		return "None";
+	}
+
+	static TextureCompression TextureCompressionFromString(std::string_view compression)
+	{
+		if (compression == "BC1") return TextureCompression::BC1;
+		if (compression == "BC3") return TextureCompression::BC3;
+		if (compression == "BC7") return TextureCompression::BC7;
+
+		return TextureCompression::None;
+	}
+
 	static AssetType GetAssetTypeFromFileExtension(const std::filesystem::path& extension)
 	{
 		if (s_AssetExtensionMap.find(extension) == s_AssetExtensionMap.end())
@@ -108,6 +130,13 @@ namespace Cobra {
 				out << YAML::Key << "Handle" << YAML::Value << handle;
 				out << YAML::Key << "FilePath" << YAML::Value << metadata.FilePath.generic_string();
 				out << YAML::Key << "Type" << YAML::Value << AssetTypeToString(metadata.Type);
+
+				if (metadata.Type == AssetType::Texture2D)
+				{
+					out << YAML::Key << "GenerateMips" << YAML::Value << metadata.TextureSettings.GenerateMips;
+					out << YAML::Key << "Compression" << YAML::Value << TextureCompressionToString(metadata.TextureSettings.Compression);
+				}
+
 				out << YAML::EndMap;
 			}
 
@@ -145,6 +174,12 @@ namespace Cobra {
 			auto& metadata = m_AssetRegistry[handle];
 			metadata.FilePath = node["FilePath"].as<std::string>();
 			metadata.Type = AssetTypeFromString(node["Type"].as<std::string>());
+
+			// Registries written before the settings existed use the defaults
+			if (auto generateMips = node["GenerateMips"])
+				metadata.TextureSettings.GenerateMips = generateMips.as<bool>();
+			if (auto compression = node["Compression"])
+				metadata.TextureSettings.Compression = TextureCompressionFromString(compression.as<std::string>());
 		}
 
 		return true;
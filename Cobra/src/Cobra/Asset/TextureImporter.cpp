@@ -2,6 +2,7 @@
 #include "TextureImporter.h"
 
 #include <Cobra/Project/Project.h>
+#include <Cobra/Renderer/TextureCompressor.h>
 
 #include <stb_image.h>
 
@@ -11,10 +12,10 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		return LoadTexture2D(Project::GetActiveAssetDirectory() / metadata.FilePath);
+		return LoadTexture2D(Project::GetActiveAssetDirectory() / metadata.FilePath, metadata.TextureSettings, true);
 	}
 
-	Ref<Texture2D> TextureImporter::LoadTexture2D(const std::filesystem::path& path)
+	Ref<Texture2D> TextureImporter::LoadTexture2D(const std::filesystem::path& path, const TextureImportSettings& settings, bool async)
 	{
 		CB_PROFILE_FUNCTION();
 
@@ -26,7 +27,11 @@ namespace Cobra {
 			CB_PROFILE_SCOPE("stbi_load - TextureImporter::ImportTexture2D");
 			std::string pathStr = path.string();
 
-			data.Data = stbi_load(pathStr.c_str(), &width, &height, &channels, 0);
+			// The block compressors take RGBA
+			int desiredChannels = settings.Compression != TextureCompression::None ? 4 : 0;
+			data.Data = stbi_load(pathStr.c_str(), &width, &height, &channels, desiredChannels);
+			if (desiredChannels)
+				channels = desiredChannels;
 		}
 
 		if (data.Data == nullptr)
@@ -40,6 +45,7 @@ namespace Cobra {
 		TextureSpecification spec;
 		spec.Width = width;
 		spec.Height = height;
+		spec.GenerateMips = settings.GenerateMips;
 
 		switch (channels)
 		{
@@ -47,7 +53,24 @@ namespace Cobra {
 			case 4: spec.Format = ImageFormat::RGBA8; break;
 		}
 
-		Ref<Texture2D> texture = Texture2D::Create(spec, data);
+		switch (settings.Compression)
+		{
+			case TextureCompression::BC1: spec.Format = ImageFormat::BC1; break;
+			case TextureCompression::BC3: spec.Format = ImageFormat::BC3; break;
+			case TextureCompression::BC7: spec.Format = ImageFormat::BC7; break;
+		}
+
+		if (TextureCompressor::IsCompressed(spec.Format))
+		{
+			Buffer compressed = TextureCompressor::Compress(spec.Format, data.Data, width, height, spec.GenerateMips);
+			data.Release();
+			data = compressed;
+		}
+
+		Ref<Texture2D> texture = Texture2D::Create(spec, async ? Buffer() : data);
+		if (async)
+			texture->SetDataAsync(data);
+
 		data.Release();
 		return texture;
 	}
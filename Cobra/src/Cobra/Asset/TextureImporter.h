@@ -8,11 +8,12 @@ namespace Cobra {
 	class TextureImporter
 	{
 	public:
-		// AssetMetadata filepath is relative to project asset directory
+		// AssetMetadata filepath is relative to project asset directory, the texture is uploaded asynchronously
 		static Ref<Texture2D> ImportTexture2D(AssetHandle handle, const AssetMetadata& metadata);
 
-		// Reads file directly from filesystem (i.e. path has to be relative/absolute to working directory)
-		static Ref<Texture2D> LoadTexture2D(const std::filesystem::path& path);
+		// Reads file directly from filesystem (i.e. path has to be relative/absolute to working directory).
+		// An async texture is uploaded over the next frames and is not loaded until then.
+		static Ref<Texture2D> LoadTexture2D(const std::filesystem::path& path, const TextureImportSettings& settings = TextureImportSettings(), bool async = false);
 	};
 
 }
\ No newline at end of file
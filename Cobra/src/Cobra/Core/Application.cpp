@@ -4,6 +4,7 @@
 #include "Cobra/Core/Log.h"
 #include "Cobra/Core/Input.h"
 #include "Cobra/Renderer/Renderer.h"
+#include "Cobra/Renderer/RenderThread.h"
 #include "Cobra/Scripting/ScriptEngine.h"
 #include "Cobra/Utils/PlatformUtils.h"
 
@@ -23,13 +24,27 @@ namespace Cobra {
 		if (!m_Specification.WorkingDirecory.empty())
 			std::filesystem::current_path(m_Specification.WorkingDirecory);
 
-		m_Window = Window::Create(WindowProps(m_Specification.Name, 1600, 900, m_Specification.CustomTitlebar));
-		m_Window->SetEventCallback(CB_BIND_EVENT_FN(Application::OnEvent));
+		if (m_Specification.Headless)
+			RendererAPI::SetAPI(RendererAPI::API::None);
+		else
+		{
+			m_Window = Window::Create(WindowProps(m_Specification.Name, 1600, 900, m_Specification.CustomTitlebar));
+			m_Window->SetEventCallback(CB_BIND_EVENT_FN(Application::OnEvent));
+		}
+
+		m_ThreadPool = CreateScope<ThreadPool>();
 
-		Renderer::Init();
+		// Has to own the context before anything is created on it
+		if (m_Specification.Renderer.RenderThread)
+			RenderThread::Start(m_Window ? m_Window->GetContext() : nullptr, m_Specification.Renderer.FramesInFlight);
 
-		m_ImGuiLayer = new ImGuiLayer();
-		PushOverlay(m_ImGuiLayer);
+		Renderer::Init(m_Specification.Renderer);
+
+		if (!m_Specification.Headless)
+		{
+			m_ImGuiLayer = new ImGuiLayer();
+			PushOverlay(m_ImGuiLayer);
+		}
 	}
 
 	Application::~Application()
@@ -38,6 +53,9 @@ namespace Cobra {
 
 		ScriptEngine::Shutdown();
 		Renderer::Shutdown();
+
+		// Resources released after this are destroyed on the main thread again
+		RenderThread::Stop();
 	}
 
 	void Application::OnEvent(Event& e)
@@ -92,11 +110,12 @@ namespace Cobra {
 		{
 			CB_PROFILE_SCOPE("RunLoop");
 
-			float time = Time::GetTime();
+			float time = m_Specification.Headless ? m_HeadlessTimer.Elapsed() : Time::GetTime();
 			Timestep timestep = time - m_LastFrameTime;
 			m_LastFrameTime = time;
 
 			ExecuteMainThreadQueue();
+			Renderer::BeginFrame();
 
 			if (!m_Minimized)
 			{
@@ -107,17 +126,23 @@ namespace Cobra {
 						layer->OnUpdate(timestep);
 				}
 
-				m_ImGuiLayer->Begin();
+				if (m_ImGuiLayer)
 				{
-					CB_PROFILE_SCOPE("LayerStack OnImGuiRender");
-
-					for (Layer* layer : m_LayerStack)
-						layer->OnImGuiRender();
+					m_ImGuiLayer->Begin();
+					{
+						CB_PROFILE_SCOPE("LayerStack OnImGuiRender");
+
+						for (Layer* layer : m_LayerStack)
+							layer->OnImGuiRender();
+					}
+					m_ImGuiLayer->End();
 				}
-				m_ImGuiLayer->End();
 			}
 
-			m_Window->OnUpdate();
+			if (m_Window)
+				m_Window->OnUpdate();
+
+			Renderer::EndFrame();
 		}
 	}
 
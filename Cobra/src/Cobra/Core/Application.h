@@ -7,6 +7,10 @@
 #include "Cobra/Events/ApplicationEvent.h"
 
 #include "Cobra/Core/Timestep.h"
+#include "Cobra/Core/Timer.h"
+#include "Cobra/Core/ThreadPool.h"
+
+#include "Cobra/Renderer/Renderer.h"
 
 #include "Cobra/ImGui/ImGuiLayer.h"
 
@@ -32,6 +36,10 @@ namespace Cobra {
 		std::string WorkingDirecory;
 		ApplicationCommandLineArgs CommandLineArgs;
 		bool CustomTitlebar = false;
+		RendererSpecification Renderer;
+
+		// No window or ImGui, and rendering goes through the recording null backend
+		bool Headless = false;
 	};
 
 	class Application
@@ -51,6 +59,7 @@ namespace Cobra {
 
 		inline Window& GetWindow() { return *m_Window; }
 		inline ImGuiLayer* GetImGuiLayer() { return m_ImGuiLayer; }
+		inline ThreadPool& GetThreadPool() { return *m_ThreadPool; }
 
 		inline static Application& Get() { return *s_Instance; }
 
@@ -73,9 +82,11 @@ namespace Cobra {
 
 		ApplicationSpecification m_Specification;
 		Scope<Window> m_Window;
-		ImGuiLayer* m_ImGuiLayer;
+		Scope<ThreadPool> m_ThreadPool;
+		ImGuiLayer* m_ImGuiLayer = nullptr;
 		LayerStack m_LayerStack;
 
+		Timer m_HeadlessTimer; // There is no GLFW to ask for the time
 		float m_LastFrameTime = 0.0f;
 
 		bool m_Running = true;
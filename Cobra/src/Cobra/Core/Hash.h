@@ -0,0 +1,33 @@
+#pragma once
+
+#include <stdint.h>
+#include <string_view>
+
+namespace Cobra {
+
+	// 64-bit FNV-1a. Unlike std::hash it is stable across runs and platforms, so it can key on-disk caches.
+	class Hash
+	{
+	public:
+		static constexpr uint64_t FNVOffsetBasis = 14695981039346656037ull;
+		static constexpr uint64_t FNVPrime = 1099511628211ull;
+
+		static uint64_t FNV(const void* data, uint64_t size, uint64_t hash = FNVOffsetBasis)
+		{
+			const uint8_t* bytes = (const uint8_t*)data;
+			for (uint64_t i = 0; i < size; i++)
+			{
+				hash ^= bytes[i];
+				hash *= FNVPrime;
+			}
+
+			return hash;
+		}
+
+		static uint64_t FNV(std::string_view string, uint64_t hash = FNVOffsetBasis)
+		{
+			return FNV(string.data(), string.size(), hash);
+		}
+	};
+
+}
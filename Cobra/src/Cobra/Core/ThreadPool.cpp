@@ -0,0 +1,148 @@
+#include "cbpch.h"
+#include "ThreadPool.h"
+
+namespace Cobra {
+
+	ThreadPool::ThreadPool(uint32_t threadCount)
+	{
+		CB_PROFILE_FUNCTION();
+
+		if (threadCount == 0)
+			threadCount = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+
+		m_Workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++)
+			m_Workers.emplace_back([this]() { WorkerLoop(); });
+	}
+
+	ThreadPool::~ThreadPool()
+	{
+		CB_PROFILE_FUNCTION();
+
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			m_Stopping = true;
+		}
+		m_Condition.notify_all();
+
+		for (std::thread& worker : m_Workers)
+			worker.join();
+	}
+
+	void ThreadPool::Submit(const std::function<void()>& job)
+	{
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			m_Jobs.push(job);
+		}
+		m_Condition.notify_one();
+	}
+
+	void ThreadPool::SubmitBackground(const std::function<void()>& job)
+	{
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			m_BackgroundJobs.push(job);
+		}
+		m_Condition.notify_one();
+	}
+
+	struct ParallelForState
+	{
+		const std::function<void(uint32_t)>* Job; // Only called while an index is left, so the caller is still waiting
+		uint32_t JobCount = 0;
+		std::atomic<uint32_t> NextJob = 0;
+		std::atomic<uint32_t> CompletedJobs = 0;
+
+		std::mutex DoneMutex;
+		std::condition_variable DoneCondition;
+
+		void Run()
+		{
+			uint32_t completed = 0;
+			for (uint32_t index = NextJob++; index < JobCount; index = NextJob++)
+			{
+				(*Job)(index);
+				completed++;
+			}
+
+			if (completed && (CompletedJobs += completed) == JobCount)
+			{
+				std::scoped_lock<std::mutex> lock(DoneMutex);
+				DoneCondition.notify_all();
+			}
+		}
+	};
+
+	void ThreadPool::ParallelFor(uint32_t jobCount, const std::function<void(uint32_t)>& job)
+	{
+		CB_PROFILE_FUNCTION();
+
+		if (jobCount == 0)
+			return;
+
+		// Helpers may outlive this call, so they share the state rather than referencing this stack frame
+		Ref<ParallelForState> state = CreateRef<ParallelForState>();
+		state->Job = &job;
+		state->JobCount = jobCount;
+
+		uint32_t helperCount = std::min(GetThreadCount(), jobCount - 1);
+		{
+			std::scoped_lock<std::mutex> lock(m_Mutex);
+			for (uint32_t i = 0; i < helperCount; i++)
+				m_HelperJobs.push([state]() { state->Run(); });
+		}
+		m_Condition.notify_all();
+
+		state->Run();
+
+		std::unique_lock<std::mutex> lock(state->DoneMutex);
+		state->DoneCondition.wait(lock, [&]() { return state->CompletedJobs == jobCount; });
+	}
+
+	void ThreadPool::WorkerLoop()
+	{
+		while (true)
+		{
+			std::function<void()> job;
+			bool background = false;
+			{
+				std::unique_lock<std::mutex> lock(m_Mutex);
+				auto canRunBackground = [this]() { return !m_BackgroundJobs.empty() && m_RunningBackgroundJobs == 0; };
+				m_Condition.wait(lock, [&]() { return m_Stopping || !m_Jobs.empty() || !m_HelperJobs.empty() || canRunBackground(); });
+
+				if (!m_HelperJobs.empty())
+				{
+					job = std::move(m_HelperJobs.front());
+					m_HelperJobs.pop();
+				}
+				else if (!m_Jobs.empty())
+				{
+					job = std::move(m_Jobs.front());
+					m_Jobs.pop();
+				}
+				else if (canRunBackground())
+				{
+					job = std::move(m_BackgroundJobs.front());
+					m_BackgroundJobs.pop();
+					m_RunningBackgroundJobs++;
+					background = true;
+				}
+				else
+					return;
+			}
+
+			job();
+
+			if (background)
+			{
+				{
+					std::scoped_lock<std::mutex> lock(m_Mutex);
+					m_RunningBackgroundJobs--;
+				}
+				m_Condition.notify_one();
+			}
+		}
+	}
+
+}
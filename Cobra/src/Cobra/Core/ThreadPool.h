@@ -0,0 +1,44 @@
+#pragma once
+
+#include "Cobra/Core/Core.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <queue>
+#include <functional>
+#include <atomic>
+
+namespace Cobra {
+
+	class ThreadPool
+	{
+	private:
+		std::vector<std::thread> m_Workers;
+		std::queue<std::function<void()>> m_Jobs;
+		std::queue<std::function<void()>> m_HelperJobs; // ParallelFor helpers, picked before any other job
+		std::queue<std::function<void()>> m_BackgroundJobs; // Picked only when nothing else is queued
+		uint32_t m_RunningBackgroundJobs = 0;
+
+		std::mutex m_Mutex;
+		std::condition_variable m_Condition;
+		bool m_Stopping = false;
+	public:
+		// A thread count of 0 uses one worker per hardware thread, minus the calling thread
+		ThreadPool(uint32_t threadCount = 0);
+		~ThreadPool();
+
+		void Submit(const std::function<void()>& job);
+		// For long running work nothing waits on, one runs at a time so the other workers stay free
+		void SubmitBackground(const std::function<void()>& job);
+
+		// Runs job(0) .. job(jobCount - 1) on the workers and the calling thread, returns once all are done.
+		// Helpers that only get a worker afterwards find nothing left and exit.
+		void ParallelFor(uint32_t jobCount, const std::function<void(uint32_t)>& job);
+
+		uint32_t GetThreadCount() const { return (uint32_t)m_Workers.size(); }
+	private:
+		void WorkerLoop();
+	};
+
+}
@@ -7,6 +7,8 @@
 
 namespace Cobra {
 
+	class GraphicsContext;
+
 	struct WindowProps
 	{
 		std::string Title;
@@ -49,6 +51,7 @@ namespace Cobra {
 		virtual void Restore() = 0;
 
 		virtual void* GetNativeWindow() const = 0;
+		virtual GraphicsContext* GetContext() const = 0;
 
 		static Scope<Window> Create(const WindowProps& props = WindowProps());
 	};
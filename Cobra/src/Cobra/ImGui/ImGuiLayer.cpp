@@ -2,6 +2,8 @@
 #include "ImGuiLayer.h"
 
 #include "Cobra/Core/Application.h"
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 
 #include <imgui.h>
 #include <imgui_internal.h>
@@ -16,6 +18,27 @@
 
 namespace Cobra {
 
+	struct DrawDataSnapshot
+	{
+		ImDrawData DrawData;
+		std::vector<ImDrawList*> CmdLists;
+
+		DrawDataSnapshot(const ImDrawData* drawData)
+			: DrawData(*drawData)
+		{
+			for (int i = 0; i < drawData->CmdListsCount; i++)
+				CmdLists.push_back(drawData->CmdLists[i]->CloneOutput());
+
+			DrawData.CmdLists = CmdLists.data();
+		}
+
+		~DrawDataSnapshot()
+		{
+			for (ImDrawList* cmdList : CmdLists)
+				IM_DELETE(cmdList);
+		}
+	};
+
 	ImGuiLayer::ImGuiLayer()
 		: Layer("ImGuiLayer")
 	{ }
@@ -34,7 +57,8 @@ namespace Cobra {
 		io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;       // Enable Keyboard Controls
 		//io.ConfigFlags |= ImGuiConfigFlags_NavEnableGamepad;      // Enable Gamepad Controls
 		io.ConfigFlags |= ImGuiConfigFlags_DockingEnable;           // Enable Docking
-		io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;         // Enable Multi-Viewport / Platform Windows
+		if (!Application::Get().GetSpecification().Renderer.RenderThread)
+			io.ConfigFlags |= ImGuiConfigFlags_ViewportsEnable;     // Enable Multi-Viewport / Platform Windows, which render on the main thread
 		//io.ConfigFlags |= ImGuiConfigFlags_ViewportsNoTaskBarIcons;
 		//io.ConfigFlags |= ImGuiConfigFlags_ViewportsNoMerge;
 
@@ -60,14 +84,20 @@ namespace Cobra {
 
 		// Setup Platform/Renderer bindings
 		ImGui_ImplGlfw_InitForOpenGL(window, true);
-		ImGui_ImplOpenGL3_Init("#version 410");
+		RenderThread::Execute([]()
+		{
+			ImGui_ImplOpenGL3_Init("#version 410");
+
+			// Otherwise the first NewFrame builds the font atlas, while the main thread is already using it
+			ImGui_ImplOpenGL3_CreateDeviceObjects();
+		});
 	}
 
 	void ImGuiLayer::OnDetach()
 	{
 		CB_PROFILE_FUNCTION();
 
-		ImGui_ImplOpenGL3_Shutdown();
+		RenderThread::ExecuteAfterFrames([]() { ImGui_ImplOpenGL3_Shutdown(); });
 		ImGui_ImplGlfw_Shutdown();
 		ImGui::DestroyContext();
 	}
@@ -86,7 +116,7 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		ImGui_ImplOpenGL3_NewFrame();
+		RenderThread::Submit([]() { ImGui_ImplOpenGL3_NewFrame(); });
 		ImGui_ImplGlfw_NewFrame();
 		ImGui::NewFrame();
 		ImGuizmo::BeginFrame();
@@ -102,7 +132,10 @@ namespace Cobra {
 
 		// Rendering
 		ImGui::Render();
-		ImGui_ImplOpenGL3_RenderDrawData(ImGui::GetDrawData());
+
+		// ImGui reuses its draw lists next frame, so a render thread gets its own copy
+		Ref<DrawDataSnapshot> snapshot = RenderThread::IsRunning() ? CreateRef<DrawDataSnapshot>(ImGui::GetDrawData()) : nullptr;
+		RenderThread::Submit([snapshot]() { ImGui_ImplOpenGL3_RenderDrawData(snapshot ? &snapshot->DrawData : ImGui::GetDrawData()); });
 
 		if (io.ConfigFlags & ImGuiConfigFlags_ViewportsEnable)
 		{
@@ -111,6 +144,9 @@ namespace Cobra {
 			ImGui::RenderPlatformWindowsDefault();
 			glfwMakeContextCurrent(backup_current_context);
 		}
+
+		// The backend restores what it touches, but not through the state cache
+		RenderThread::Submit([]() { OpenGLStateCache::Invalidate(); });
 	}
 
 	void ImGuiLayer::SetDarkThemeColors()
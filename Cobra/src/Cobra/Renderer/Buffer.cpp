@@ -2,6 +2,8 @@
 #include "Buffer.h"
 
 #include "Cobra/Renderer/Renderer.h"
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/Null/NullBuffer.h"
 #include "Platform/OpenGL/OpenGLBuffer.h"
 
 namespace Cobra {
@@ -10,8 +12,8 @@ namespace Cobra {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:     CB_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
-			case RendererAPI::API::OpenGL:   return CreateRef<OpenGLVertexBuffer>(size);
+			case RendererAPI::API::None:     return CreateRef<NullVertexBuffer>(size);
+			case RendererAPI::API::OpenGL:   return RenderThread::CreateResource<OpenGLVertexBuffer>(size);
 		}
 
 		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
@@ -22,8 +24,20 @@ namespace Cobra {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:     CB_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
-			case RendererAPI::API::OpenGL:   return CreateRef<OpenGLVertexBuffer>(vertices, size);
+			case RendererAPI::API::None:     return CreateRef<NullVertexBuffer>(vertices, size);
+			case RendererAPI::API::OpenGL:   return RenderThread::CreateResource<OpenGLVertexBuffer>(vertices, size);
+		}
+
+		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
+	Ref<StreamingVertexBuffer> StreamingVertexBuffer::Create(uint32_t regionSize, uint32_t regionCount)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:     return CreateRef<NullStreamingVertexBuffer>(regionSize, regionCount);
+			case RendererAPI::API::OpenGL:   return RenderThread::CreateResource<OpenGLStreamingVertexBuffer>(regionSize, regionCount);
 		}
 
 		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
@@ -34,8 +48,8 @@ namespace Cobra {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:     CB_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
-			case RendererAPI::API::OpenGL:   return CreateRef<OpenGLIndexBuffer>(indices, count);
+			case RendererAPI::API::None:     return CreateRef<NullIndexBuffer>(indices, count);
+			case RendererAPI::API::OpenGL:   return RenderThread::CreateResource<OpenGLIndexBuffer>(indices, count);
 		}
 
 		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
@@ -12,7 +12,12 @@ namespace Cobra {
 		Float, Float2, Float3, Float4,
 		Int, Int2, Int3, Int4,
 		Mat3, Mat4, 
-		Bool
+		Bool,
+
+		// Packed types, read as floats in the shader (set Normalized to map them to [0, 1])
+		UByte, UByte4,
+		UShort2, UShort4,
+		Half, Half2
 	};
 
 	static uint32_t ShaderDataTypeSize(ShaderDataType type)
@@ -30,6 +35,12 @@ namespace Cobra {
 			case ShaderDataType::Mat3:     return 4 * 3 * 3;
 			case ShaderDataType::Mat4:     return 4 * 4 * 4;
 			case ShaderDataType::Bool:     return 1;
+			case ShaderDataType::UByte:    return 1;
+			case ShaderDataType::UByte4:   return 1 * 4;
+			case ShaderDataType::UShort2:  return 2 * 2;
+			case ShaderDataType::UShort4:  return 2 * 4;
+			case ShaderDataType::Half:     return 2;
+			case ShaderDataType::Half2:    return 2 * 2;
 		}
 
 		CB_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -49,6 +60,17 @@ namespace Cobra {
 			: Type(type), Name(name), Size(ShaderDataTypeSize(type)), Offset(0), Normalized(normalized)
 		{ }
 
+		// Unused bytes that keep the following elements aligned, does not take up an attribute location
+		static BufferElement Padding(uint32_t size)
+		{
+			BufferElement element;
+			element.Type = ShaderDataType::None;
+			element.Size = size;
+			element.Offset = 0;
+			element.Normalized = false;
+			return element;
+		}
+
 		uint32_t GetComponentCount() const
 		{
 			switch (Type)
@@ -64,6 +86,12 @@ namespace Cobra {
 				case ShaderDataType::Mat3:    return 3 * 3;
 				case ShaderDataType::Mat4:    return 4 * 4;
 				case ShaderDataType::Bool:    return 1;
+				case ShaderDataType::UByte:   return 1;
+				case ShaderDataType::UByte4:  return 4;
+				case ShaderDataType::UShort2: return 2;
+				case ShaderDataType::UShort4: return 4;
+				case ShaderDataType::Half:    return 1;
+				case ShaderDataType::Half2:   return 2;
 			}
 
 			CB_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -84,6 +112,12 @@ namespace Cobra {
 			CalculateOffsetsAndStride();
 		}
 
+		BufferLayout(const std::vector<BufferElement>& elements)
+			: m_Elements(elements)
+		{
+			CalculateOffsetsAndStride();
+		}
+
 		inline uint32_t GetStride() const { return m_Stride; }
 		inline const std::vector<BufferElement>& GetElements() const { return m_Elements; }
 
@@ -106,6 +140,12 @@ namespace Cobra {
 		}
 	};
 
+	enum class VertexInputRate
+	{
+		PerVertex = 0,
+		PerInstance
+	};
+
 	class VertexBuffer
 	{
 	public:
@@ -123,6 +163,26 @@ namespace Cobra {
 		static Ref<VertexBuffer> Create(float* vertices, uint32_t size);
 	};
 
+	// Persistently mapped vertex buffer split into a ring of regions. The CPU writes
+	// vertices straight into the current region, which is fenced once the draws
+	// reading from it have been submitted so it is never overwritten in flight.
+	class StreamingVertexBuffer : public VertexBuffer
+	{
+	public:
+		virtual ~StreamingVertexBuffer() = default;
+
+		// Waits until the GPU is done with the current region and returns a pointer to it
+		virtual void* BeginRegion() = 0;
+		// Fences the current region, of which the first size bytes were written, and advances to the next one
+		virtual void EndRegion(uint32_t size) = 0;
+
+		virtual uint32_t GetRegionOffset() const = 0;
+		virtual uint32_t GetRegionSize() const = 0;
+		virtual uint32_t GetRegionCount() const = 0;
+
+		static Ref<StreamingVertexBuffer> Create(uint32_t regionSize, uint32_t regionCount = 3);
+	};
+
 	class IndexBuffer
 	{
 	public:
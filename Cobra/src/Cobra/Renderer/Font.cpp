@@ -2,15 +2,273 @@
 #include "Font.h"
 #include "MSDFData.h"
 
+#include "Cobra/Core/FileSystem.h"
+#include "Cobra/Core/Hash.h"
+#include "Cobra/Core/Application.h"
+
 #undef INFINITE
 #include <msdf-atlas-gen.h>
 #include <FontGeometry.h>
 #include <GlyphGeometry.h>
 
+#include <unordered_set>
+
+#define DEFAULT_ANGLE_THRESHOLD 3.0
+#define LCG_MULTIPLIER 6364136223846793005ull
+#define LCG_INCREMENT 1442695040888963407ull
+#define THREAD_COUNT 8
+
 namespace Cobra {
 
+    namespace Utils {
+
+        static const char* GetCacheDirectory()
+        {
+            // TODO: make sure the assets directory is valid
+            return "assets/cache/font";
+        }
+
+        static void CreateCacheDirectoryIfNeeded()
+        {
+            std::string cacheDirectory = GetCacheDirectory();
+            if (!std::filesystem::exists(cacheDirectory))
+                std::filesystem::create_directories(cacheDirectory);
+        }
+
+    }
+
+    // Written in front of the atlas pixels, a cached atlas is only used if it matches the packed glyphs
+    struct FontAtlasCacheHeader
+    {
+        char Magic[4] = { 'C', 'B', 'F', 'A' };
+        uint32_t Version = 1;
+        uint32_t Width = 0, Height = 0;
+        uint32_t GlyphCount = 0;
+        uint32_t Channels = 3;
+    };
+
+    // Without pixels the atlas is cleared on the GPU
+    static Ref<Texture2D> CreateAtlasTexture(const void* pixels, uint32_t width, uint32_t height)
+    {
+        TextureSpecification spec;
+        spec.Width = width;
+        spec.Height = height;
+        spec.Format = ImageFormat::RGB8;
+        spec.GenerateMips = false;
+
+        Ref<Texture2D> texture = Texture2D::Create(spec);
+        if (pixels)
+            texture->SetData(Buffer(pixels, width * height * 3));
+        else
+            texture->Clear();
+
+        return texture;
+    }
+
+    static Ref<Texture2D> LoadCachedAtlas(const std::filesystem::path& cachePath, uint32_t width, uint32_t height, uint32_t glyphCount)
+    {
+        ScopedBuffer data = FileSystem::ReadFileBinary(cachePath);
+        if (!data || data.Size() < sizeof(FontAtlasCacheHeader))
+            return nullptr;
+
+        FontAtlasCacheHeader expected;
+        expected.Width = width;
+        expected.Height = height;
+        expected.GlyphCount = glyphCount;
+
+        const FontAtlasCacheHeader& header = *data.As<FontAtlasCacheHeader>();
+        if (memcmp(&header, &expected, sizeof(FontAtlasCacheHeader)) != 0 || data.Size() != sizeof(FontAtlasCacheHeader) + (uint64_t)width * height * 3)
+        {
+            CB_CORE_WARN("Font atlas cache {} is out of date", cachePath.string());
+            return nullptr;
+        }
+
+        return CreateAtlasTexture(data.Data() + sizeof(FontAtlasCacheHeader), width, height);
+    }
+
+    static FontGlyph CreateFontGlyph(const msdf_atlas::GlyphGeometry& glyph, uint32_t page, uint32_t pageWidth, uint32_t pageHeight)
+    {
+        FontGlyph result;
+        result.Page = page;
+        result.Advance = (float)glyph.getAdvance();
+
+        double l, b, r, t;
+        glyph.getQuadPlaneBounds(l, b, r, t);
+        result.QuadMin = { (float)l, (float)b };
+        result.QuadMax = { (float)r, (float)t };
+
+        glyph.getQuadAtlasBounds(l, b, r, t);
+        result.TexCoordMin = { (float)(l / pageWidth), (float)(b / pageHeight) };
+        result.TexCoordMax = { (float)(r / pageWidth), (float)(t / pageHeight) };
+
+        return result;
+    }
+
+    // Generates requested glyphs in background jobs on the thread pool. At most one job runs per font, so
+    // the FreeType handles and the page packing state are never used concurrently.
+    struct FontGlyphPager
+    {
+        struct GeneratedGlyph
+        {
+            uint32_t Codepoint = 0;
+            bool Valid = false; // False if the font has no glyph for the codepoint
+            FontGlyph Glyph;
+
+            // Region of the page the pixels go into
+            uint32_t X = 0, Y = 0, Width = 0, Height = 0;
+            std::vector<uint8_t> Pixels;
+        };
+
+        static const uint32_t PageSize = 1024;
+        static const uint32_t MaxJobGlyphs = 16; // Keeps jobs short, the workers also record draws
+
+        std::filesystem::path Filepath;
+        double Scale = 0.0, PixelRange = 0.0, MiterLimit = 0.0, GeometryScale = 1.0;
+
+        std::mutex Mutex;
+        std::unordered_set<uint32_t> Requested;
+        std::vector<uint32_t> Queue;
+        std::vector<GeneratedGlyph> Generated;
+        bool Running = false;
+
+        // Only used by the running job. The font is loaded by the first job, so fonts that
+        // never need more than the Latin range never open it again.
+        bool Loaded = false;
+        Buffer FontData;
+        msdfgen::FreetypeHandle* FreeType = nullptr;
+        msdfgen::FontHandle* FontHandle = nullptr;
+        uint32_t Page = 1, ShelfX = 0, ShelfY = 0, ShelfHeight = 0; // Page 0 is the eagerly generated atlas
+
+        ~FontGlyphPager()
+        {
+            if (FontHandle)
+                msdfgen::destroyFont(FontHandle);
+            if (FreeType)
+                msdfgen::deinitializeFreetype(FreeType);
+
+            FontData.Release();
+        }
+
+        void LoadFont()
+        {
+            Loaded = true;
+
+            FontData = FileSystem::ReadFileBinary(Filepath);
+            FreeType = msdfgen::initializeFreetype();
+            if (FontData && FreeType)
+                FontHandle = msdfgen::loadFontData(FreeType, FontData.Data, (int)FontData.Size);
+
+            if (!FontHandle)
+                CB_CORE_ERROR("Failed to load font for glyph paging: {}", Filepath.string());
+        }
+
+        // Shelf packs a box into the current page, moving on to a new page once it is full
+        bool Allocate(uint32_t width, uint32_t height, uint32_t& outX, uint32_t& outY)
+        {
+            // Gap between boxes so sampling never bleeds into a neighbour
+            uint32_t paddedWidth = width + 1, paddedHeight = height + 1;
+            if (paddedWidth > PageSize || paddedHeight > PageSize)
+                return false;
+
+            if (ShelfX + paddedWidth > PageSize)
+            {
+                ShelfX = 0;
+                ShelfY += ShelfHeight;
+                ShelfHeight = 0;
+            }
+
+            if (ShelfY + paddedHeight > PageSize)
+            {
+                Page++;
+                ShelfX = ShelfY = ShelfHeight = 0;
+            }
+
+            outX = ShelfX;
+            outY = ShelfY;
+            ShelfX += paddedWidth;
+            ShelfHeight = std::max(ShelfHeight, paddedHeight);
+            return true;
+        }
+
+        void Generate(uint32_t codepoint, GeneratedGlyph& result)
+        {
+            result.Codepoint = codepoint;
+
+            msdf_atlas::GlyphGeometry glyph;
+            if (!FontHandle || !glyph.load(FontHandle, GeometryScale, codepoint))
+                return;
+
+            result.Valid = true;
+            if (glyph.isWhitespace())
+            {
+                result.Glyph.Advance = (float)glyph.getAdvance();
+                return;
+            }
+
+            glyph.edgeColoring(msdfgen::edgeColoringInkTrap, DEFAULT_ANGLE_THRESHOLD, 0);
+            glyph.wrapBox(Scale, PixelRange / Scale, MiterLimit);
+
+            int width, height;
+            glyph.getBoxSize(width, height);
+            if (!Allocate(width, height, result.X, result.Y))
+            {
+                result.Valid = false;
+                return;
+            }
+
+            // Generated on its own and uploaded into the page afterwards
+            msdf_atlas::GeneratorAttributes attributes;
+            attributes.config.overlapSupport = true;
+            attributes.scanlinePass = true;
+
+            glyph.placeBox(0, 0);
+            msdf_atlas::ImmediateAtlasGenerator<float, 3, msdf_atlas::msdfGenerator, msdf_atlas::BitmapAtlasStorage<uint8_t, 3>> generator(width, height);
+            generator.setAttributes(attributes);
+            generator.setThreadCount(1);
+            generator.generate(&glyph, 1);
+
+            msdfgen::BitmapConstRef<uint8_t, 3> bitmap = (msdfgen::BitmapConstRef<uint8_t, 3>)generator.atlasStorage();
+            result.Width = (uint32_t)width;
+            result.Height = (uint32_t)height;
+            result.Pixels.assign(bitmap.pixels, bitmap.pixels + (size_t)width * height * 3);
+
+            glyph.placeBox((int)result.X, (int)result.Y);
+            result.Glyph = CreateFontGlyph(glyph, Page, PageSize, PageSize);
+        }
+
+        static void Run(const Ref<FontGlyphPager>& pager)
+        {
+            CB_PROFILE_FUNCTION();
+
+            std::vector<uint32_t> codepoints;
+            {
+                std::scoped_lock<std::mutex> lock(pager->Mutex);
+
+                size_t count = std::min<size_t>(pager->Queue.size(), MaxJobGlyphs);
+                codepoints.assign(pager->Queue.begin(), pager->Queue.begin() + count);
+                pager->Queue.erase(pager->Queue.begin(), pager->Queue.begin() + count);
+            }
+
+            if (!pager->Loaded)
+                pager->LoadFont();
+
+            std::vector<GeneratedGlyph> generated(codepoints.size());
+            for (size_t i = 0; i < codepoints.size(); i++)
+                pager->Generate(codepoints[i], generated[i]);
+
+            std::scoped_lock<std::mutex> lock(pager->Mutex);
+            pager->Generated.insert(pager->Generated.end(), std::make_move_iterator(generated.begin()), std::make_move_iterator(generated.end()));
+
+            // Requeued rather than looped so other fonts get a turn
+            if (pager->Queue.empty())
+                pager->Running = false;
+            else
+                Application::Get().GetThreadPool().SubmitBackground([pager]() { Run(pager); });
+        }
+    };
+
     template<typename T, typename S, int N, msdf_atlas::GeneratorFunction<S, N> GenFunc>
-    static Ref<Texture2D> CreateAndCacheAtlas(const std::string& fontName, float fontSize, const std::vector<msdf_atlas::GlyphGeometry>& glyphs, const msdf_atlas::FontGeometry& fontGeometry, uint32_t width, uint32_t height)
+    static Ref<Texture2D> CreateAndCacheAtlas(const std::filesystem::path& cachePath, const std::vector<msdf_atlas::GlyphGeometry>& glyphs, const msdf_atlas::FontGeometry& fontGeometry, uint32_t width, uint32_t height)
     {
         msdf_atlas::GeneratorAttributes attributes;
         attributes.config.overlapSupport = true;
@@ -22,16 +280,23 @@ namespace Cobra {
         generator.generate(glyphs.data(), (int)glyphs.size());
 
         msdfgen::BitmapConstRef<T, N> bitmap = (msdfgen::BitmapConstRef<T, N>)generator.atlasStorage();
-        
-        TextureSpecification spec;
-        spec.Width = bitmap.width;
-        spec.Height = bitmap.height;
-        spec.Format = ImageFormat::RGB8;
-        spec.GenerateMips = false;
 
-        Ref<Texture2D> texture = Texture2D::Create(spec);
-        texture->SetData(Buffer((void*)bitmap.pixels, bitmap.width * bitmap.height * 3));
-        return texture;
+        FontAtlasCacheHeader header;
+        header.Width = bitmap.width;
+        header.Height = bitmap.height;
+        header.GlyphCount = (uint32_t)glyphs.size();
+        header.Channels = N;
+
+        std::ofstream out(cachePath, std::ios::out | std::ios::binary);
+        if (out.is_open())
+        {
+            out.write((const char*)&header, sizeof(header));
+            out.write((const char*)bitmap.pixels, (std::streamsize)bitmap.width * bitmap.height * N * sizeof(T));
+            out.flush();
+            out.close();
+        }
+
+        return CreateAtlasTexture(bitmap.pixels, bitmap.width, bitmap.height);
     }
 
 	Font::Font(const std::filesystem::path& filepath)
@@ -42,11 +307,13 @@ namespace Cobra {
 
         std::string fileString = filepath.string();
 
-        // TODO: msdfgen::loadFontData loads from memory buffer which we'll need
-        msdfgen::FontHandle* font = msdfgen::loadFont(ft, fileString.c_str());
+        // The file contents are hashed for the atlas cache, so the font is loaded from the same buffer
+        ScopedBuffer fontData = FileSystem::ReadFileBinary(filepath);
+        msdfgen::FontHandle* font = fontData ? msdfgen::loadFontData(ft, fontData.Data(), (int)fontData.Size()) : nullptr;
         if (!font)
         {
             CB_CORE_ERROR("Failed to load font: {}", fileString);
+            msdfgen::deinitializeFreetype(ft);
             return;
         }
 
@@ -74,11 +341,13 @@ namespace Cobra {
         CB_CORE_INFO("Loaded {} glyphs from font (out of {})", glyphsLoaded, charset.size());
 
         double emSize = 40.0;
+        double pixelRange = 2.0;
+        double miterLimit = 1.0;
 
         msdf_atlas::TightAtlasPacker atlasPacker;
         // atlasPacker.setDimensionsConstraint()
-        atlasPacker.setPixelRange(2.0);
-        atlasPacker.setMiterLimit(1.0);
+        atlasPacker.setPixelRange(pixelRange);
+        atlasPacker.setMiterLimit(miterLimit);
         atlasPacker.setPadding(0);
         atlasPacker.setScale(emSize);
 
@@ -87,12 +356,38 @@ namespace Cobra {
 
         int width, height;
         atlasPacker.getDimensions(width, height);
+
+        // Glyph geometry is cheap to load and pack, the atlas is what is expensive to generate. The cache is
+        // keyed by everything the atlas depends on: font contents, charset and atlas parameters.
+        uint64_t cacheKey = Hash::FNV(fontData.Data(), fontData.Size());
+        cacheKey = Hash::FNV(charsetRanges, sizeof(charsetRanges), cacheKey);
+        for (double parameter : { emSize, pixelRange, miterLimit })
+            cacheKey = Hash::FNV(&parameter, sizeof(parameter), cacheKey);
+
         emSize = atlasPacker.getScale();
 
-#define DEFAULT_ANGLE_THRESHOLD 3.0
-#define LCG_MULTIPLIER 6364136223846793005ull
-#define LCG_INCREMENT 1442695040888963407ull
-#define THREAD_COUNT 8
+        for (const msdf_atlas::GlyphGeometry& glyph : m_Data->Glyphs)
+            m_Glyphs[glyph.getCodepoint()] = CreateFontGlyph(glyph, 0, width, height);
+
+        m_Pager = CreateRef<FontGlyphPager>();
+        m_Pager->Filepath = filepath;
+        m_Pager->Scale = emSize;
+        m_Pager->PixelRange = pixelRange;
+        m_Pager->MiterLimit = miterLimit;
+        m_Pager->GeometryScale = m_Data->FontGeometry.getGeometryScale();
+
+        Utils::CreateCacheDirectoryIfNeeded();
+        std::filesystem::path cachePath = std::filesystem::path(Utils::GetCacheDirectory()) / fmt::format("{}.{:016x}.msdfatlas", filepath.stem().string(), cacheKey);
+
+        Ref<Texture2D> atlasTexture = LoadCachedAtlas(cachePath, width, height, (uint32_t)m_Data->Glyphs.size());
+        if (atlasTexture)
+        {
+            m_AtlasPages.push_back(atlasTexture);
+
+            msdfgen::destroyFont(font);
+            msdfgen::deinitializeFreetype(ft);
+            return;
+        }
 
         uint64_t coloringSeed = 0;
         bool expensiveColoring = false;
@@ -114,7 +409,7 @@ namespace Cobra {
             }
         }
 
-        m_AtlasTexture = CreateAndCacheAtlas<uint8_t, float, 3, msdf_atlas::msdfGenerator>("Test", (float)emSize, m_Data->Glyphs, m_Data->FontGeometry, width, height);
+        m_AtlasPages.push_back(CreateAndCacheAtlas<uint8_t, float, 3, msdf_atlas::msdfGenerator>(cachePath, m_Data->Glyphs, m_Data->FontGeometry, width, height));
 
         msdfgen::destroyFont(font);
         msdfgen::deinitializeFreetype(ft);
@@ -125,6 +420,82 @@ namespace Cobra {
         delete m_Data;
     }
 
+    float Font::GetAdvance(uint32_t codepoint, uint32_t nextCodepoint) const
+    {
+        // Kerning is only known between glyphs of the eagerly loaded charset
+        double advance;
+        if (m_Data->FontGeometry.getAdvance(advance, codepoint, nextCodepoint))
+            return (float)advance;
+
+        const FontGlyph* glyph = GetGlyph(codepoint);
+        return glyph ? glyph->Advance : 0.0f;
+    }
+
+    bool Font::RequestGlyph(uint32_t codepoint)
+    {
+        if (!m_Pager)
+            return false;
+
+        std::scoped_lock<std::mutex> lock(m_Pager->Mutex);
+        if (!m_Pager->Requested.insert(codepoint).second)
+            return false;
+
+        m_Pager->Queue.push_back(codepoint);
+        if (!m_Pager->Running)
+        {
+            m_Pager->Running = true;
+            Application::Get().GetThreadPool().SubmitBackground([pager = m_Pager]() { FontGlyphPager::Run(pager); });
+        }
+
+        return true;
+    }
+
+    bool Font::UpdateGlyphPages()
+    {
+        if (!m_Pager)
+            return false;
+
+        std::vector<FontGlyphPager::GeneratedGlyph> generated;
+        bool pending;
+        {
+            std::scoped_lock<std::mutex> lock(m_Pager->Mutex);
+            generated.swap(m_Pager->Generated);
+            pending = m_Pager->Running;
+        }
+
+        if (generated.empty())
+            return pending;
+
+        CB_PROFILE_FUNCTION();
+
+        const FontGlyph* fallback = GetGlyph('?');
+        FontGlyph fallbackGlyph = fallback ? *fallback : FontGlyph();
+
+        for (FontGlyphPager::GeneratedGlyph& result : generated)
+        {
+            // Codepoints the font has no glyph for show up as '?' from now on
+            if (!result.Valid)
+            {
+                if (fallback)
+                    m_Glyphs[result.Codepoint] = fallbackGlyph;
+                continue;
+            }
+
+            if (!result.Pixels.empty())
+            {
+                while (m_AtlasPages.size() <= result.Glyph.Page)
+                    m_AtlasPages.push_back(CreateAtlasTexture(nullptr, FontGlyphPager::PageSize, FontGlyphPager::PageSize));
+
+                m_AtlasPages[result.Glyph.Page]->SetData(Buffer(result.Pixels.data(), result.Pixels.size()), result.X, result.Y, result.Width, result.Height);
+            }
+
+            m_Glyphs[result.Codepoint] = result.Glyph;
+        }
+
+        m_GlyphVersion++;
+        return pending;
+    }
+
     Ref<Font> Font::GetDefault()
     {
         static Ref<Font> DefaultFont;
@@ -1,26 +1,65 @@
 #pragma once
 
 #include <filesystem>
+#include <unordered_map>
 
 #include <Cobra/Renderer/Texture.h>
 
+#include <glm/glm.hpp>
+
 namespace Cobra {
 
 	struct MSDFData;
+	struct FontGlyphPager;
 
+	struct FontGlyph
+	{
+		glm::vec2 QuadMin, QuadMax; // Plane bounds in em units
+		glm::vec2 TexCoordMin, TexCoordMax; // Normalized over the atlas page
+		float Advance = 0.0f;
+		uint32_t Page = 0;
+	};
+
+	// The Latin range is generated up front into page 0, every other glyph is generated in the
+	// background the first time it is requested and packed into additional atlas pages.
 	class Font
 	{
 	private:
 		MSDFData* m_Data = nullptr;
-		Ref<Texture2D> m_AtlasTexture;
+		std::vector<Ref<Texture2D>> m_AtlasPages;
+
+		// Only modified by UpdateGlyphPages, so lookups are safe while recording
+		std::unordered_map<uint32_t, FontGlyph> m_Glyphs;
+		uint32_t m_GlyphVersion = 0;
+
+		Ref<FontGlyphPager> m_Pager; // Shared with the generation jobs, which may outlive the font
 	public:
 		Font(const std::filesystem::path& filepath);
 		~Font();
 
 		const MSDFData* GetMSDFData() const { return m_Data; }
-		Ref<Texture2D> GetAtlasTexture() const { return m_AtlasTexture; }
+		// Null if the font failed to load
+		Ref<Texture2D> GetAtlasTexture(uint32_t page = 0) const { return page < m_AtlasPages.size() ? m_AtlasPages[page] : nullptr; }
+		uint32_t GetAtlasPageCount() const { return (uint32_t)m_AtlasPages.size(); }
+
+		const FontGlyph* GetGlyph(uint32_t codepoint) const
+		{
+			auto it = m_Glyphs.find(codepoint);
+			return it != m_Glyphs.end() ? &it->second : nullptr;
+		}
+
+		// Advance from codepoint to nextCodepoint including kerning, in em units
+		float GetAdvance(uint32_t codepoint, uint32_t nextCodepoint) const;
+
+		// Queues a missing glyph for generation, returns false if it was already requested. Thread safe.
+		bool RequestGlyph(uint32_t codepoint);
+		// Uploads generated glyphs and makes them available to GetGlyph, returns true while
+		// requested glyphs are still being generated. Must not be called while recording.
+		bool UpdateGlyphPages();
+		// Incremented whenever UpdateGlyphPages adds glyphs
+		uint32_t GetGlyphVersion() const { return m_GlyphVersion; }
 
 		static Ref<Font> GetDefault();
 	};
 
-}
\ No newline at end of file
+}
@@ -2,6 +2,8 @@
 #include "Framebuffer.h"
 
 #include "Cobra/Renderer/Renderer.h"
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/Null/NullFramebuffer.h"
 #include "Platform/OpenGL/OpenGLFramebuffer.h"
 
 namespace Cobra {
@@ -10,8 +12,8 @@ namespace Cobra {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:     CB_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
-			case RendererAPI::API::OpenGL:   return CreateRef<OpenGLFramebuffer>(spec);
+			case RendererAPI::API::None:     return CreateRef<NullFramebuffer>(spec);
+			case RendererAPI::API::OpenGL:   return RenderThread::CreateResource<OpenGLFramebuffer>(spec);
 		}
 
 		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
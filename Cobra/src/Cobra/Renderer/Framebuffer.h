@@ -57,6 +57,12 @@ namespace Cobra {
 		virtual void Resize(uint32_t width, uint32_t height) = 0;
 		virtual int ReadPixel(uint32_t attachmentIndex, int x, int y) = 0;
 
+		// Queues a read of a single pixel without waiting on the GPU, the framebuffer must be bound.
+		// Requests made while every previous read is still in flight are dropped.
+		virtual void RequestPixel(uint32_t attachmentIndex, int x, int y) = 0;
+		// Returns true and the value of the most recent finished request if one finished since the last poll
+		virtual bool PollPixel(int& outValue) = 0;
+
 		virtual void ClearAttachment(uint32_t attachmentIndex, int value) = 0;
 
 		virtual uint32_t GetColorAttachmentRendererID(uint32_t index = 0) = 0;
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Cobra {
+
+	// Clip planes of a view projection matrix, used to cull bounding boxes against the camera
+	class Frustum
+	{
+	private:
+		glm::vec4 m_Planes[6]; // Left, right, bottom, top, near, far. Points inside are on the positive side
+	public:
+		Frustum()
+			: Frustum(glm::mat4(1.0f))
+		{ }
+
+		Frustum(const glm::mat4& viewProjection)
+		{
+			glm::vec4 rows[4];
+			for (int i = 0; i < 4; i++)
+				rows[i] = { viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i] };
+
+			m_Planes[0] = rows[3] + rows[0];
+			m_Planes[1] = rows[3] - rows[0];
+			m_Planes[2] = rows[3] + rows[1];
+			m_Planes[3] = rows[3] - rows[1];
+			m_Planes[4] = rows[3] + rows[2];
+			m_Planes[5] = rows[3] - rows[2];
+		}
+
+		bool Intersects(const glm::vec3& min, const glm::vec3& max) const
+		{
+			for (const glm::vec4& plane : m_Planes)
+			{
+				// Corner of the box furthest along the plane normal
+				glm::vec3 corner = {
+					plane.x >= 0.0f ? max.x : min.x,
+					plane.y >= 0.0f ? max.y : min.y,
+					plane.z >= 0.0f ? max.z : min.z
+				};
+
+				if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+					return false;
+			}
+
+			return true;
+		}
+	};
+
+}
@@ -9,6 +9,10 @@ namespace Cobra {
 
 		virtual void Init() = 0;
 		virtual void SwapBuffers() = 0;
+
+		// Binds the context to the calling thread, or unbinds it so another thread can take it
+		virtual void MakeCurrent() = 0;
+		virtual void ReleaseCurrent() = 0;
 	};
 
 }
\ No newline at end of file
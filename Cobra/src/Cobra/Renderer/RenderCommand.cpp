@@ -1,10 +1,33 @@
 #include "cbpch.h"
 #include "RenderCommand.h"
 
-#include "Platform/OpenGL/OpenGLRendererAPI.h"
-
 namespace Cobra {
 
-	Scope<RendererAPI> RenderCommand::s_RendererAPI = CreateScope<OpenGLRendererAPI>();
+	Scope<RendererAPI> RenderCommand::s_RendererAPI;
+
+	static RendererAPI::StateStatistics s_PublishedStateStatistics;
+	static std::mutex s_PublishedStateStatisticsMutex;
+
+	RendererAPI::StateStatistics RenderCommand::GetStateStatistics()
+	{
+		if (!RenderThread::IsRunning())
+			return s_RendererAPI->GetStateStatistics();
+
+		std::scoped_lock<std::mutex> lock(s_PublishedStateStatisticsMutex);
+		return s_PublishedStateStatistics;
+	}
+
+	void RenderCommand::ResetStateStatistics()
+	{
+		RenderThread::Submit([]()
+		{
+			{
+				std::scoped_lock<std::mutex> lock(s_PublishedStateStatisticsMutex);
+				s_PublishedStateStatistics = s_RendererAPI->GetStateStatistics();
+			}
+
+			s_RendererAPI->ResetStateStatistics();
+		});
+	}
 
-}
\ No newline at end of file
+}
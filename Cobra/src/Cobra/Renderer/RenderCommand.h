@@ -1,24 +1,30 @@
 #pragma once
 
 #include "RendererAPI.h"
+#include "RenderThread.h"
 
 namespace Cobra {
 
+	// Every command is recorded through the render thread, and runs right away without one
 	class RenderCommand
 	{
 	private:
 		static Scope<RendererAPI> s_RendererAPI;
 	public:
-		inline static void Init() { s_RendererAPI->Init(); }
-		inline static void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) { s_RendererAPI->SetViewport(x, y, width, height); }
+		inline static void Init() { s_RendererAPI = RendererAPI::Create(); RenderThread::Submit([]() { s_RendererAPI->Init(); }); }
+		inline static void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) { RenderThread::Submit([=]() { s_RendererAPI->SetViewport(x, y, width, height); }); }
+		// Queries the context, so with a render thread this has to be called from a render command
+		inline static void GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) { s_RendererAPI->GetViewport(x, y, width, height); }
 
-		inline static void SetClearColor(const glm::vec4& color) { s_RendererAPI->SetClearColor(color); }
-		inline static void Clear() { s_RendererAPI->Clear(); }
+		inline static void SetClearColor(const glm::vec4& color) { RenderThread::Submit([=]() { s_RendererAPI->SetClearColor(color); }); }
+		inline static void Clear() { RenderThread::Submit([]() { s_RendererAPI->Clear(); }); }
 
-		inline static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) { s_RendererAPI->DrawIndexed(vertexArray, indexCount); }
-		inline static void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) { s_RendererAPI->DrawLines(vertexArray, vertexCount); }
+		inline static void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t vertexOffset = 0) { RenderThread::Submit([=]() { s_RendererAPI->DrawIndexed(vertexArray, indexCount, vertexOffset); }); }
+		inline static void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t instanceOffset = 0) { RenderThread::Submit([=]() { s_RendererAPI->DrawIndexedInstanced(vertexArray, indexCount, instanceCount, instanceOffset); }); }
 
-		inline static void SetLineWidth(float width) { s_RendererAPI->SetLineWidth(width); }
+		// With a render thread these are the statistics of the frame it finished before the last reset
+		static RendererAPI::StateStatistics GetStateStatistics();
+		static void ResetStateStatistics();
 	};
 
-}
\ No newline at end of file
+}
@@ -0,0 +1,61 @@
+#include "cbpch.h"
+#include "RenderCommandQueue.h"
+
+namespace Cobra {
+
+	RenderCommandQueue::RenderCommandQueue()
+	{
+		m_Blocks.emplace_back().Data.resize(BlockSize);
+	}
+
+	RenderCommandQueue::~RenderCommandQueue()
+	{
+		CB_CORE_ASSERT(m_CommandCount == 0, "Render commands were never executed!");
+	}
+
+	void* RenderCommandQueue::Allocate(CommandFn function, uint32_t size)
+	{
+		size = (size + Alignment - 1) & ~(Alignment - 1);
+		CB_CORE_ASSERT(HeaderSize + size <= BlockSize, "Render command is too large!");
+
+		if (m_Blocks[m_BlockIndex].Used + HeaderSize + size > BlockSize)
+		{
+			if (++m_BlockIndex == m_Blocks.size())
+				m_Blocks.emplace_back().Data.resize(BlockSize);
+		}
+
+		Block& block = m_Blocks[m_BlockIndex];
+		uint8_t* command = block.Data.data() + block.Used;
+		block.Used += HeaderSize + size;
+
+		CommandHeader* header = (CommandHeader*)command;
+		header->Function = function;
+		header->Size = size;
+
+		m_CommandCount++;
+		return command + HeaderSize;
+	}
+
+	void RenderCommandQueue::Execute()
+	{
+		CB_PROFILE_FUNCTION();
+
+		for (uint32_t i = 0; i <= m_BlockIndex; i++)
+		{
+			Block& block = m_Blocks[i];
+			for (uint32_t offset = 0; offset < block.Used;)
+			{
+				CommandHeader* header = (CommandHeader*)(block.Data.data() + offset);
+				header->Function(block.Data.data() + offset + HeaderSize);
+
+				offset += HeaderSize + header->Size;
+			}
+
+			block.Used = 0;
+		}
+
+		m_BlockIndex = 0;
+		m_CommandCount = 0;
+	}
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "Cobra/Core/Core.h"
+
+#include <vector>
+
+namespace Cobra {
+
+	// Commands are stored back to back in fixed size blocks, so their storage does not move while more are
+	// allocated and a queue reused every frame stops allocating once it has grown to fit a frame.
+	class RenderCommandQueue
+	{
+	public:
+		typedef void(*CommandFn)(void*);
+
+		static const uint32_t Alignment = 16;
+	private:
+		struct CommandHeader
+		{
+			CommandFn Function;
+			uint32_t Size; // Of the storage that follows, rounded up to Alignment
+		};
+
+		struct Block
+		{
+			std::vector<uint8_t> Data;
+			uint32_t Used = 0;
+		};
+
+		static const uint32_t BlockSize = 256 * 1024;
+		static const uint32_t HeaderSize = (sizeof(CommandHeader) + Alignment - 1) & ~(Alignment - 1);
+
+		std::vector<Block> m_Blocks;
+		uint32_t m_BlockIndex = 0; // Block being written to
+		uint32_t m_CommandCount = 0;
+	public:
+		RenderCommandQueue();
+		~RenderCommandQueue();
+
+		// Returns storage for a command that is passed to function on execution, function has to destroy it
+		void* Allocate(CommandFn function, uint32_t size);
+
+		// Runs every command in submission order and leaves the queue empty
+		void Execute();
+
+		uint32_t GetCommandCount() const { return m_CommandCount; }
+	};
+
+}
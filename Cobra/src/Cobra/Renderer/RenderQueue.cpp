@@ -0,0 +1,65 @@
+#include "cbpch.h"
+#include "RenderQueue.h"
+
+#include <glm/glm.hpp>
+
+namespace Cobra {
+
+	uint64_t RenderQueue::MakeKey(uint8_t layer, float depth, uint32_t shader, uint32_t texture, int entityID)
+	{
+		// Depth is normalized [0, 1] with 0 being the far plane, so farther commands sort first
+		uint64_t depthBits = (uint64_t)(glm::clamp(depth, 0.0f, 1.0f) * (float)0xFFFFFF);
+
+		return ((uint64_t)layer << 56)
+			| (depthBits << 32)
+			| ((uint64_t)(shader & 0xF) << 28)
+			| ((uint64_t)std::min(texture, 0xFFFu) << 16)
+			| ((uint64_t)(entityID + 1) & 0xFFFF);
+	}
+
+	void RenderQueue::Sort()
+	{
+		CB_PROFILE_FUNCTION();
+
+		const size_t count = m_Commands.size();
+		if (count < 2)
+			return;
+
+		// LSD radix sort, 8 bits per pass. All histograms are built in a single read and
+		// passes where every key shares the same byte are skipped entirely.
+		uint32_t histograms[8][256] = {};
+		for (const Command& command : m_Commands)
+		{
+			for (uint32_t pass = 0; pass < 8; pass++)
+				histograms[pass][(command.Key >> (pass * 8)) & 0xFF]++;
+		}
+
+		m_Scratch.resize(count);
+		Command* src = m_Commands.data();
+		Command* dst = m_Scratch.data();
+
+		for (uint32_t pass = 0; pass < 8; pass++)
+		{
+			uint32_t* histogram = histograms[pass];
+			if (histogram[(src[0].Key >> (pass * 8)) & 0xFF] == count)
+				continue;
+
+			uint32_t offset = 0;
+			for (uint32_t i = 0; i < 256; i++)
+			{
+				uint32_t bucketCount = histogram[i];
+				histogram[i] = offset;
+				offset += bucketCount;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				dst[histogram[(src[i].Key >> (pass * 8)) & 0xFF]++] = src[i];
+
+			std::swap(src, dst);
+		}
+
+		if (src != m_Commands.data())
+			m_Commands.swap(m_Scratch);
+	}
+
+}
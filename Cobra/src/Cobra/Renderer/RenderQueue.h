@@ -0,0 +1,38 @@
+#pragma once
+
+#include <vector>
+
+namespace Cobra {
+
+	// Deferred list of draw commands ordered by a 64-bit sort key. Keys are packed
+	// most significant first: | layer 8 | depth 24 | shader 4 | texture 12 | entity 16 |
+	class RenderQueue
+	{
+	public:
+		struct Command
+		{
+			uint64_t Key;
+			uint32_t Index; // Into the submitter's payload storage
+		};
+	private:
+		std::vector<Command> m_Commands;
+		std::vector<Command> m_Scratch;
+	public:
+		static uint64_t MakeKey(uint8_t layer, float depth, uint32_t shader, uint32_t texture, int entityID);
+		static uint32_t GetShader(uint64_t key) { return (uint32_t)(key >> 28) & 0xF; }
+		static uint32_t GetTexture(uint64_t key) { return (uint32_t)(key >> 16) & 0xFFF; }
+		static uint64_t SetTexture(uint64_t key, uint32_t texture) { return (key & ~(0xFFFull << 16)) | ((uint64_t)std::min(texture, 0xFFFu) << 16); }
+
+		void Submit(uint64_t key, uint32_t index) { m_Commands.push_back({ key, index }); }
+		void Sort();
+		void Clear() { m_Commands.clear(); }
+		void Reserve(uint32_t count) { m_Commands.reserve(count); }
+
+		uint32_t GetCount() const { return (uint32_t)m_Commands.size(); }
+		bool IsEmpty() const { return m_Commands.empty(); }
+
+		std::vector<Command>::const_iterator begin() const { return m_Commands.begin(); }
+		std::vector<Command>::const_iterator end() const { return m_Commands.end(); }
+	};
+
+}
@@ -0,0 +1,213 @@
+#include "cbpch.h"
+#include "RenderThread.h"
+
+#include <thread>
+#include <deque>
+#include <condition_variable>
+#include <atomic>
+
+namespace Cobra {
+
+	struct ImmediateJob
+	{
+		const std::function<void()>* Function;
+		bool Done = false;
+	};
+
+	struct RenderThreadData
+	{
+		std::thread Thread;
+		std::thread::id ThreadID;
+		std::atomic<bool> Running = false;
+		GraphicsContext* Context = nullptr;
+
+		uint32_t FramesInFlight = 1;
+		std::vector<Scope<RenderCommandQueue>> Queues;
+		RenderCommandQueue* RecordingQueue = nullptr;
+		std::deque<RenderCommandQueue*> KickedQueues; // Front is executing
+		std::vector<RenderCommandQueue*> FreeQueues;
+		std::vector<ImmediateJob*> ImmediateJobs;
+		std::vector<ImmediateJob*> AfterFramesJobs; // Wait for the kicked frames to finish
+		bool Stopping = false;
+
+		std::mutex SubmitMutex; // Guards the recording queue
+		std::mutex Mutex; // Guards everything the render thread picks work from
+		std::condition_variable WorkAvailable;
+		std::condition_variable WorkDone;
+	};
+
+	static RenderThreadData s_Data;
+
+	static void RenderThreadLoop()
+	{
+		if (s_Data.Context)
+			s_Data.Context->MakeCurrent();
+
+		std::unique_lock<std::mutex> lock(s_Data.Mutex);
+		while (true)
+		{
+			s_Data.WorkAvailable.wait(lock, []()
+			{
+				return s_Data.Stopping || !s_Data.KickedQueues.empty() || !s_Data.ImmediateJobs.empty() || !s_Data.AfterFramesJobs.empty();
+			});
+
+			// Jobs that change objects the kicked frames still use wait until those have executed
+			bool afterFrames = s_Data.ImmediateJobs.empty() && s_Data.KickedQueues.empty() && !s_Data.AfterFramesJobs.empty();
+			if (!s_Data.ImmediateJobs.empty() || afterFrames)
+			{
+				std::vector<ImmediateJob*>& pending = afterFrames ? s_Data.AfterFramesJobs : s_Data.ImmediateJobs;
+				std::vector<ImmediateJob*> jobs = std::move(pending);
+				pending.clear();
+
+				lock.unlock();
+				for (ImmediateJob* job : jobs)
+					(*job->Function)();
+				lock.lock();
+
+				for (ImmediateJob* job : jobs)
+					job->Done = true;
+				s_Data.WorkDone.notify_all();
+			}
+			else if (!s_Data.KickedQueues.empty())
+			{
+				RenderCommandQueue* queue = s_Data.KickedQueues.front();
+
+				lock.unlock();
+				queue->Execute();
+				lock.lock();
+
+				s_Data.KickedQueues.pop_front();
+				s_Data.FreeQueues.push_back(queue);
+				s_Data.WorkDone.notify_all();
+			}
+			else
+				break;
+		}
+
+		if (s_Data.Context)
+			s_Data.Context->ReleaseCurrent();
+	}
+
+	void RenderThread::Start(GraphicsContext* context, uint32_t framesInFlight)
+	{
+		CB_PROFILE_FUNCTION();
+
+		CB_CORE_ASSERT(!s_Data.Running, "Render thread is already running!");
+		CB_CORE_ASSERT(framesInFlight > 0);
+
+		s_Data.Context = context;
+		s_Data.FramesInFlight = framesInFlight;
+
+		// One more than can be in flight, for the frame being recorded
+		for (uint32_t i = 0; i < framesInFlight + 1; i++)
+			s_Data.FreeQueues.push_back(s_Data.Queues.emplace_back(CreateScope<RenderCommandQueue>()).get());
+
+		s_Data.RecordingQueue = s_Data.FreeQueues.back();
+		s_Data.FreeQueues.pop_back();
+		s_Data.Stopping = false;
+
+		if (context)
+			context->ReleaseCurrent();
+
+		s_Data.Thread = std::thread(RenderThreadLoop);
+		s_Data.ThreadID = s_Data.Thread.get_id();
+		s_Data.Running = true;
+	}
+
+	void RenderThread::Stop()
+	{
+		CB_PROFILE_FUNCTION();
+
+		if (!s_Data.Running)
+			return;
+
+		Kick();
+
+		{
+			std::scoped_lock<std::mutex> lock(s_Data.Mutex);
+			s_Data.Stopping = true;
+		}
+		s_Data.WorkAvailable.notify_one();
+
+		s_Data.Thread.join();
+		s_Data.Running = false;
+		s_Data.ThreadID = std::thread::id();
+
+		if (s_Data.Context)
+			s_Data.Context->MakeCurrent();
+
+		s_Data.RecordingQueue = nullptr;
+		s_Data.FreeQueues.clear();
+		s_Data.Queues.clear();
+	}
+
+	bool RenderThread::IsRunning()
+	{
+		return s_Data.Running;
+	}
+
+	bool RenderThread::IsRenderThread()
+	{
+		return std::this_thread::get_id() == s_Data.ThreadID;
+	}
+
+	void RenderThread::Execute(const std::function<void()>& func)
+	{
+		ExecuteImmediate(func, false);
+	}
+
+	void RenderThread::ExecuteAfterFrames(const std::function<void()>& func)
+	{
+		ExecuteImmediate(func, true);
+	}
+
+	void RenderThread::ExecuteImmediate(const std::function<void()>& func, bool afterFrames)
+	{
+		if (!IsRunning() || IsRenderThread())
+		{
+			func();
+			return;
+		}
+
+		CB_PROFILE_FUNCTION();
+
+		ImmediateJob job = { &func };
+
+		std::unique_lock<std::mutex> lock(s_Data.Mutex);
+		(afterFrames ? s_Data.AfterFramesJobs : s_Data.ImmediateJobs).push_back(&job);
+		s_Data.WorkAvailable.notify_one();
+		s_Data.WorkDone.wait(lock, [&job]() { return job.Done; });
+	}
+
+	void RenderThread::Kick()
+	{
+		if (!IsRunning())
+			return;
+
+		CB_PROFILE_FUNCTION();
+
+		std::unique_lock<std::mutex> lock(s_Data.Mutex);
+		s_Data.WorkDone.wait(lock, []() { return s_Data.KickedQueues.size() < s_Data.FramesInFlight; });
+
+		{
+			std::scoped_lock<std::mutex> submitLock(s_Data.SubmitMutex);
+
+			s_Data.KickedQueues.push_back(s_Data.RecordingQueue);
+			s_Data.RecordingQueue = s_Data.FreeQueues.back();
+			s_Data.FreeQueues.pop_back();
+		}
+
+		s_Data.WorkAvailable.notify_one();
+	}
+
+	RenderCommandQueue& RenderThread::GetRecordingQueue()
+	{
+		return *s_Data.RecordingQueue;
+	}
+
+	std::mutex& RenderThread::GetSubmitMutex()
+	{
+		return s_Data.SubmitMutex;
+	}
+
+}
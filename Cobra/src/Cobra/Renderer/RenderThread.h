@@ -0,0 +1,96 @@
+#pragma once
+
+#include "Cobra/Core/Core.h"
+#include "Cobra/Core/Buffer.h"
+#include "Cobra/Renderer/RenderCommandQueue.h"
+#include "Cobra/Renderer/GraphicsContext.h"
+
+#include <functional>
+#include <mutex>
+
+namespace Cobra {
+
+	// Optional thread that owns the graphics context. The main thread records frame N into a command queue
+	// while the render thread executes frame N - 1. Without it, or when called from it, commands run right away.
+	class RenderThread
+	{
+	public:
+		// Moves the context over to a new thread. Kick blocks while framesInFlight frames are waiting or executing.
+		static void Start(GraphicsContext* context, uint32_t framesInFlight = 1);
+		// Executes everything recorded so far and moves the context back to the calling thread
+		static void Stop();
+
+		static bool IsRunning();
+		static bool IsRenderThread();
+
+		// Records a command into the current frame, safe to call from any thread
+		template<typename FuncT>
+		static void Submit(FuncT&& func)
+		{
+			if (!IsRunning() || IsRenderThread())
+			{
+				func();
+				return;
+			}
+
+			using CommandT = std::decay_t<FuncT>;
+			static_assert(alignof(CommandT) <= RenderCommandQueue::Alignment);
+
+			auto command = [](void* storage)
+			{
+				CommandT* func = (CommandT*)storage;
+				(*func)();
+				func->~CommandT();
+			};
+
+			std::scoped_lock<std::mutex> lock(GetSubmitMutex());
+			new (GetRecordingQueue().Allocate(command, sizeof(CommandT))) CommandT(std::forward<FuncT>(func));
+		}
+
+		// Submits func(data), copying data first if the command does not run right away
+		template<typename FuncT>
+		static void Submit(Buffer data, FuncT&& func)
+		{
+			if (!IsRunning() || IsRenderThread())
+			{
+				func(data);
+				return;
+			}
+
+			Submit([copy = Buffer::Copy(data), func = std::forward<FuncT>(func)]() mutable
+			{
+				func(copy);
+				copy.Release();
+			});
+		}
+
+		// Runs func on the render thread between frames and waits for it, for work whose result is needed
+		// right away. Commands recorded into the current frame have not run yet at that point.
+		static void Execute(const std::function<void()>& func);
+		// Like Execute, but only once every kicked frame has finished, for changes to objects those frames use
+		static void ExecuteAfterFrames(const std::function<void()>& func);
+
+		// Hands the frame recorded since the last kick to the render thread
+		static void Kick();
+
+		// Creates a graphics API object on the render thread, its deletion is recorded like any other command
+		// so it outlives the commands that were recorded before the last reference was released
+		template<typename T, typename... Args>
+		static Ref<T> CreateResource(Args&&... args)
+		{
+			if (!IsRunning())
+				return CreateRef<T>(std::forward<Args>(args)...);
+
+			T* resource = nullptr;
+			Execute([&]() { resource = new T(std::forward<Args>(args)...); });
+
+			return Ref<T>(resource, [](T* resource) { Submit([resource]() { delete resource; }); });
+		}
+	private:
+		static void ExecuteImmediate(const std::function<void()>& func, bool afterFrames);
+
+		static RenderCommandQueue& GetRecordingQueue();
+		static std::mutex& GetSubmitMutex();
+	};
+
+}
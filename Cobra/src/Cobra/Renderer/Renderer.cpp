@@ -7,12 +7,12 @@ namespace Cobra {
 
 	Scope<Renderer::SceneData> Renderer::m_SceneData = CreateScope<Renderer::SceneData>();
 
-	void Renderer::Init()
+	void Renderer::Init(const RendererSpecification& specification)
 	{
 		CB_PROFILE_FUNCTION();
 
 		RenderCommand::Init();
-		Renderer2D::Init();
+		Renderer2D::Init(specification);
 	}
 
 	void Renderer::Shutdown()
@@ -25,6 +25,21 @@ namespace Cobra {
 		RenderCommand::SetViewport(0, 0, width, height);
 	}
 
+	void Renderer::BeginFrame()
+	{
+		CB_PROFILE_FUNCTION();
+
+		uint64_t budget = Renderer2D::GetSpecification().TextureUploadBudget;
+		RenderThread::Submit([budget]() { Texture2D::UpdateAsyncUploads(budget); });
+	}
+
+	void Renderer::EndFrame()
+	{
+		CB_PROFILE_FUNCTION();
+
+		RenderThread::Kick();
+	}
+
 	void Renderer::BeginScene(OrthographicCamera& camera)
 	{ 
 		m_SceneData->ViewProjectionMatrix = camera.GetViewProjectionMatrix();
@@ -6,6 +6,42 @@
 
 namespace Cobra {
 
+	struct RendererSpecification
+	{
+		// Writes entity IDs to the second color attachment for mouse picking. Runtime
+		// builds can turn this off to drop the ID from every vertex.
+		bool EntityIDs = true;
+
+		// Primitives per Renderer2D draw call batch. A scene that does not fit is split into
+		// several draw calls, and with GrowBatches the batch then grows to fit it, up to
+		// MaxBatchCapacity primitives.
+		uint32_t QuadBatchCapacity = 4096; // Includes lines
+		uint32_t CircleBatchCapacity = 1024;
+		uint32_t GlyphBatchCapacity = 4096;
+		bool GrowBatches = true;
+		uint32_t MaxBatchCapacity = 65536;
+
+		// Draws circles and text through the quad shader as well, so a scene goes out as a
+		// single depth ordered stream. Costs a branch per fragment in the quad shader.
+		bool UnifiedPipeline = false;
+
+		// Textures up to MaxAtlasTextureSize on either side are packed into shared pages, so
+		// sprites with different textures still batch together. Tiled quads keep their own texture.
+		bool AtlasTextures = true;
+		uint32_t AtlasPageSize = 2048;
+		uint32_t MaxAtlasTextureSize = 256;
+
+		// Bytes of asynchronous texture uploads staged and issued per frame, a texture larger
+		// than this is uploaded over several frames
+		uint64_t TextureUploadBudget = 8 * 1024 * 1024;
+
+		// Executes the graphics API calls on a separate thread, while the main thread already records the
+		// next frame. Up to FramesInFlight recorded frames wait for the render thread before the main thread
+		// blocks. Multi-viewport ImGui is not available with it.
+		bool RenderThread = false;
+		uint32_t FramesInFlight = 1;
+	};
+
 	class Renderer
 	{
 	private:
@@ -16,11 +52,16 @@ namespace Cobra {
 
 		static Scope<SceneData> m_SceneData;
 	public:
-		static void Init();
+		static void Init(const RendererSpecification& specification = RendererSpecification());
 		static void Shutdown();
 
 		static void OnWindowResize(uint32_t width, uint32_t height);
 
+		// Advances asynchronous texture uploads, called by the application at the start of every frame
+		static void BeginFrame();
+		// Hands the recorded frame to the render thread, called by the application at the end of every frame
+		static void EndFrame();
+
 		static void BeginScene(OrthographicCamera& camera);
 		static void EndScene();
 
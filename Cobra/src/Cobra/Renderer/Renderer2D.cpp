@@ -6,114 +6,321 @@
 #include "Cobra/Renderer/VertexArray.h"
 #include "Cobra/Renderer/UniformBuffer.h"
 #include "Cobra/Renderer/RenderCommand.h"
+#include "Cobra/Renderer/RenderThread.h"
 #include "Cobra/Renderer/MSDFData.h"
+#include "Cobra/Renderer/RenderQueue.h"
+#include "Cobra/Renderer/TextureAtlas.h"
 
 #include <Cobra/Asset/AssetManager.h>
+#include <Cobra/Core/Application.h>
 
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/packing.hpp>
+
+#include <shared_mutex>
 
 namespace Cobra {
 
-	struct QuadVertex
+	// Quads and circles are drawn instanced over a shared unit quad, the vertex shader
+	// expands each instance as Position + local.x * AxisX + local.y * AxisY. Lines are quad
+	// instances as well, from Position to Position + AxisX and TilingFactor pixels wide.
+	// In the unified pipeline circles and glyphs are quad instances too, circles keep
+	// thickness and fade in TexRect and glyphs sample the font atlas in TexIndex.
+	// Attributes are packed and EntityID always comes last, so it can be cut off the
+	// stride when entity IDs are disabled.
+	struct QuadInstance
 	{
 		glm::vec3 Position;
-		glm::vec4 Color;
-		glm::vec2 TexCoord;
-		float TexIndex;
-		float TilingFactor;
+		glm::vec3 AxisX;
+		glm::vec3 AxisY;
+		uint32_t Color;      // RGBA8
+		uint16_t TexRect[4]; // unorm16 uv min, uv max
+		uint16_t TilingFactor; // half, line width for lines
+		uint8_t TexIndex;
+		uint8_t Flags; // QuadInstanceFlags
 
 		// Editor-only
 		int EntityID;
 	};
 
-	struct CircleVertex
+	struct CircleInstance
 	{
-		glm::vec3 WorldPosition;
-		glm::vec3 LocalPosition;
-		glm::vec4 Color;
-		float Thickness;
-		float Fade;
+		glm::vec3 Position;
+		glm::vec3 AxisX;
+		glm::vec3 AxisY;
+		uint32_t Color;         // RGBA8
+		uint32_t ThicknessFade; // half2
 
 		// Editor-only
 		int EntityID;
 	};
 
-	struct LineVertex
+	struct TextVertex
 	{
 		glm::vec3 Position;
-		glm::vec4 Color;
+		uint32_t Color;    // RGBA8
+		uint32_t TexCoord; // unorm16 x2
+		uint8_t TexIndex;  // Font atlas slot
+		uint8_t Padding[3];
+
+		// TODO: bg color for outline/bg
 
 		// Editor-only
 		int EntityID;
 	};
 
-	struct TextVertex
+	static_assert(sizeof(QuadInstance) == 56 && sizeof(CircleInstance) == 48 && sizeof(TextVertex) == 28);
+
+	static uint32_t PackColor(const glm::vec4& color)
 	{
-		glm::vec3 Position;
-		glm::vec4 Color;
-		glm::vec2 TexCoord;
+		return glm::packUnorm4x8(color);
+	}
 
-		// TODO: bg color for outline/bg
+	static void FillQuadInstance(QuadInstance& instance, const glm::mat4& transform, const glm::vec4& color, float tilingFactor, int entityID)
+	{
+		instance.Position = transform[3];
+		instance.AxisX = transform[0];
+		instance.AxisY = transform[1];
+		instance.Color = PackColor(color);
+		instance.TexRect[0] = instance.TexRect[1] = 0;
+		instance.TexRect[2] = instance.TexRect[3] = UINT16_MAX;
+		instance.TilingFactor = glm::packHalf1x16(tilingFactor);
+		instance.TexIndex = 0;
+		instance.Flags = 0;
+		instance.EntityID = entityID;
+	}
 
-		// Editor-only
-		int EntityID;
+	enum QuadInstanceFlags : uint8_t
+	{
+		QuadInstanceLine   = 1 << 0, // Expanded in screen space, see QuadInstance
+		QuadInstanceCircle = 1 << 1, // Unified pipeline only
+		QuadInstanceText   = 1 << 2  // Unified pipeline only
+	};
+
+	// Doubles as the shader field of the sort key
+	enum class PrimitiveType : uint32_t
+	{
+		Quad = 0,
+		Circle,
+		Text,
+		StaticQuads
+	};
+
+	struct QuadPayload
+	{
+		QuadInstance Instance;
+		uint32_t Texture; // Context texture index
+	};
+
+	struct GlyphPayload
+	{
+		TextVertex Vertices[4];
+		uint32_t FontAtlas; // Context texture index
+	};
+
+	struct StaticBatchPayload
+	{
+		Ref<StaticQuadBatch> Batch;
+		// The batch may be rebuilt, or recycled for another texture, before a render thread flushes it
+		Ref<Texture2D> Texture;
+		uint32_t Count;
+	};
+
+	// Glyph quads of a string in font space. Laying out text is expensive, so layouts are
+	// cached across frames and drawing a string only has to apply its transform.
+	struct TextLayout
+	{
+		struct Glyph
+		{
+			glm::vec2 QuadMin;
+			glm::vec2 QuadMax;
+			uint32_t TexCoords[4]; // unorm16 x2, in vertex order
+			uint32_t Page; // Font atlas page
+		};
+
+		// What the layout was built from, the cache is keyed by a hash of these
+		std::string String;
+		Ref<Font> FontAsset; // Keeps the font alive while the layout is cached
+		float Kerning = 0.0f;
+		float LineSpacing = 0.0f;
+
+		std::vector<Glyph> Glyphs;
+		glm::vec2 BoundsMin = glm::vec2(0.0f);
+		glm::vec2 BoundsMax = glm::vec2(0.0f);
+
+		// Layouts missing glyphs that are still being generated are redone once the font has them
+		bool Complete = true;
+		uint32_t FontGlyphVersion = 0;
+
+		std::atomic<uint32_t> LastUsedScene = 0;
+
+		bool Matches(const std::string& string, const Ref<Font>& font, float kerning, float lineSpacing) const
+		{
+			return FontAsset == font && Kerning == kerning && LineSpacing == lineSpacing && String == string
+				&& (Complete || FontGlyphVersion == font->GetGlyphVersion());
+		}
+	};
+
+	// Write cursor into the current region of a streaming buffer. A run is the
+	// contiguous range of elements that goes out in a single draw call. Elements are
+	// Stride bytes apart, which is shorter than the struct when entity IDs are disabled.
+	struct StreamCursor
+	{
+		Ref<StreamingVertexBuffer> Buffer;
+		BufferLayout Layout;
+		uint32_t Stride = 0;
+		uint32_t Capacity = 0; // Elements per region
+		uint32_t MaxCapacity = 0;
+		uint32_t Emitted = 0; // Elements pushed since the streams were last grown
+
+		uint8_t* Base = nullptr;
+		uint8_t* Ptr = nullptr;
+		uint8_t* RunStart = nullptr;
+
+		void Begin() { Base = Ptr = RunStart = (uint8_t*)Buffer->BeginRegion(); }
+		void End()
+		{
+			if (Ptr != Base)
+				Buffer->EndRegion((uint32_t)(Ptr - Base));
+			Base = Ptr = RunStart = nullptr;
+		}
+
+		void Push(const void* element)
+		{
+			memcpy(Ptr, element, Stride);
+			Ptr += Stride;
+			Emitted++;
+		}
+
+		bool HasRoom(uint32_t count) const { return (uint32_t)(Ptr - Base) / Stride + count <= Capacity; }
+		uint32_t GetRunCount() const { return (uint32_t)(Ptr - RunStart) / Stride; }
+		uint32_t GetRunOffset() const { return (Buffer->GetRegionOffset() + (uint32_t)(RunStart - Base)) / Stride; }
+	};
+
+	// Everything a thread needs to record draws on its own. Textures are indexed per
+	// context and only resolved to scene textures when the contexts are merged.
+	struct RecordingContext
+	{
+		uint32_t Index = 0;
+
+		RenderQueue Queue;
+		std::vector<QuadPayload> QuadPayloads;
+		std::vector<CircleInstance> CirclePayloads;
+		std::vector<GlyphPayload> GlyphPayloads;
+		std::vector<StaticBatchPayload> StaticBatchPayloads;
+
+		std::vector<Ref<Texture2D>> Textures; // 0 = white texture
+		std::unordered_map<uint32_t, uint32_t> TextureIndices; // Renderer ID -> context texture index
+		std::vector<uint32_t> TextureRemap; // Context texture index -> scene texture index
+
+		uint32_t QuadCount = 0;
+
+		void Reset(const Ref<Texture2D>& whiteTexture)
+		{
+			Queue.Clear();
+			QuadPayloads.clear();
+			CirclePayloads.clear();
+			GlyphPayloads.clear();
+			StaticBatchPayloads.clear();
+
+			Textures.assign(1, whiteTexture);
+			TextureIndices.clear();
+			TextureIndices[whiteTexture->GetRendererID()] = 0;
+
+			QuadCount = 0;
+		}
+	};
+
+	// The draws of one scene. Filled in by the main thread and recording threads, then handed to
+	// the render thread as a whole, so the next scene can be recorded while it is flushed.
+	struct SceneRecording
+	{
+		std::vector<Scope<RecordingContext>> Contexts; // 0 = main thread
+		uint32_t ContextCount = 1; // In use by the scene
 	};
 
 	struct Renderer2DData
 	{
-		const uint32_t MaxQuads = 20000;
-		const uint32_t MaxVertices = MaxQuads * 4;
-		const uint32_t MaxIndices = MaxQuads * 6;
 		static const uint32_t MaxTextureSlots = 32;
+		static const uint32_t MaxBatchesInFlight = 4;
+
+		// Merged commands index payloads as | context 8 | payload 24 |
+		static const uint32_t PayloadIndexBits = 24;
+		static const uint32_t PayloadIndexMask = (1 << PayloadIndexBits) - 1;
+		static const uint32_t MaxRecordingContexts = 256;
+		static const uint32_t MinRecordSliceSize = 1024;
+
+		// Text layouts not drawn for this many scenes are evicted
+		static const uint32_t TextLayoutLifetime = 256;
+
+		Ref<VertexBuffer> UnitQuadVertexBuffer;
+		Ref<IndexBuffer> UnitQuadIndexBuffer;
 
 		Ref<VertexArray> QuadVertexArray;
-		Ref<VertexBuffer> QuadVertexBuffer;
 		Ref<Shader> QuadShader;
 		Ref<Texture2D> WhiteTexture;
 
 		Ref<VertexArray> CircleVertexArray;
-		Ref<VertexBuffer> CircleVertexBuffer;
 		Ref<Shader> CircleShader;
 
-		Ref<VertexArray> LineVertexArray;
-		Ref<VertexBuffer> LineVertexBuffer;
-		Ref<Shader> LineShader;
-
 		Ref<VertexArray> TextVertexArray;
-		Ref<VertexBuffer> TextVertexBuffer;
 		Ref<Shader> TextShader;
 
-		uint32_t QuadIndexCount = 0;
-		QuadVertex* QuadVertexBufferBase = nullptr;
-		QuadVertex* QuadVertexBufferPtr = nullptr;
+		StreamCursor QuadStream;
+		StreamCursor CircleStream;
+		StreamCursor TextStream;
+
+		// Draw calls are recorded per context and only merged, sorted and batched when flushed
+		Scope<SceneRecording> Recording;
+		const SceneRecording* FlushedRecording = nullptr; // Read by the Emit functions
+		RenderQueue Queue;
+
+		// Flushed recordings come back here, so their allocations are reused
+		std::vector<Scope<SceneRecording>> FreeRecordings;
+		std::mutex FreeRecordingMutex;
+
+		std::vector<Ref<Texture2D>> SceneTextures; // 0 = white texture
+		std::unordered_map<uint32_t, uint32_t> SceneTextureIndices; // Renderer ID -> scene texture index
+		std::vector<uint32_t> SceneTextureSlots; // Scene texture index -> bound slot, 0 = unbound
 
-		uint32_t CircleIndexCount = 0;
-		CircleVertex* CircleVertexBufferBase = nullptr;
-		CircleVertex* CircleVertexBufferPtr = nullptr;
+		Scope<TextureAtlas> Atlas; // Null when atlasing is disabled
 
-		uint32_t LineVertexCount = 0;
-		LineVertex* LineVertexBufferBase = nullptr;
-		LineVertex* LineVertexBufferPtr = nullptr;
+		// Shared by all recording threads
+		std::unordered_multimap<size_t, Scope<TextLayout>> TextLayouts;
+		std::shared_mutex TextLayoutMutex;
 
-		uint32_t TextIndexCount = 0;
-		TextVertex* TextVertexBufferBase = nullptr;
-		TextVertex* TextVertexBufferPtr = nullptr;
+		// Fonts with glyphs being generated, updated between scenes
+		std::vector<Ref<Font>> PagingFonts;
+		std::mutex PagingFontMutex;
+		uint32_t SceneIndex = 0;
 
-		float LineWidth = 2.0f;
+		float LineWidth = 2.0f; // Pixels
+		uint8_t Layer = 0;
 
 		std::array<Ref<Texture2D>, MaxTextureSlots> TextureSlots;
+		std::array<uint32_t, MaxTextureSlots> TextureSlotSceneIndices;
 		uint32_t TextureSlotIndex = 1; // 0 = white texture
 
-		Ref<Texture2D> FontAtlasTexture;
-
 		glm::vec4 QuadVertexPositions[4];
 
+		// Written where the scenes are flushed. With a render thread the main thread reads the
+		// statistics published by the last reset instead.
 		Renderer2D::Statistics Stats;
+		Renderer2D::Statistics PublishedStats;
+		std::mutex StatsMutex;
+
+		RendererSpecification Specification;
+
+		// Of the scene being recorded, CameraBuffer holds the one being flushed
+		glm::mat4 ViewProjection = glm::mat4(1.0f);
+		Frustum ViewFrustum;
 
 		struct CameraData
 		{
 			glm::mat4 ViewProjection;
+			glm::vec2 ViewportSize; // Lines are sized in pixels
+			glm::vec2 Padding;
 		};
 
 		CameraData CameraBuffer;
@@ -121,30 +328,49 @@ namespace Cobra {
 	};
 
 	static Renderer2DData s_Data;
+	static thread_local RecordingContext* t_RecordingContext = nullptr;
 
-	void Renderer2D::Init()
+	// Appends a_EntityID to the layout and sizes the stream to the resulting stride
+	static void ResizeStream(StreamCursor& stream, uint32_t capacity)
 	{
-		CB_PROFILE_FUNCTION();
+		stream.Capacity = capacity;
+		stream.Buffer = StreamingVertexBuffer::Create(capacity * stream.Stride, s_Data.MaxBatchesInFlight);
+		stream.Buffer->SetLayout(stream.Layout);
+	}
 
-		s_Data.QuadVertexArray = VertexArray::Create();
+	// Capacity is in primitives of primitiveSize elements each
+	static void SetStreamLayout(StreamCursor& stream, std::vector<BufferElement> elements, uint32_t capacity, uint32_t primitiveSize = 1)
+	{
+		CB_CORE_ASSERT(capacity > 0, "Renderer2D batch capacity must not be 0!");
 
-		s_Data.QuadVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(QuadVertex));
-		s_Data.QuadVertexBuffer->SetLayout({
-			{ ShaderDataType::Float3, "a_Position"     },
-			{ ShaderDataType::Float4, "a_Color"        },
-			{ ShaderDataType::Float2, "a_TexCoord"     },
-			{ ShaderDataType::Float,  "a_TexIndex"     },
-			{ ShaderDataType::Float,  "a_TilingFactor" },
-			{ ShaderDataType::Int,    "a_EntityID"     }
-		});
-		s_Data.QuadVertexArray->AddVertexBuffer(s_Data.QuadVertexBuffer);
+		if (s_Data.Specification.EntityIDs)
+			elements.push_back({ ShaderDataType::Int, "a_EntityID" });
 
-		s_Data.QuadVertexBufferBase = new QuadVertex[s_Data.MaxVertices];
+		stream.Layout = elements;
+		stream.Stride = stream.Layout.GetStride();
+		stream.MaxCapacity = (s_Data.Specification.GrowBatches ? std::max(capacity, s_Data.Specification.MaxBatchCapacity) : capacity) * primitiveSize;
+		ResizeStream(stream, capacity * primitiveSize);
+	}
 
-		uint32_t* quadIndices = new uint32_t[s_Data.MaxIndices];
+	// Rebuilt whenever a stream grows, since vertex arrays keep the buffers they were created with
+	static void CreateVertexArrays()
+	{
+		s_Data.QuadVertexArray = VertexArray::Create();
+		s_Data.QuadVertexArray->AddVertexBuffer(s_Data.UnitQuadVertexBuffer);
+		s_Data.QuadVertexArray->AddVertexBuffer(s_Data.QuadStream.Buffer, VertexInputRate::PerInstance);
+		s_Data.QuadVertexArray->SetIndexBuffer(s_Data.UnitQuadIndexBuffer);
+
+		s_Data.CircleVertexArray = VertexArray::Create();
+		s_Data.CircleVertexArray->AddVertexBuffer(s_Data.UnitQuadVertexBuffer);
+		s_Data.CircleVertexArray->AddVertexBuffer(s_Data.CircleStream.Buffer, VertexInputRate::PerInstance);
+		s_Data.CircleVertexArray->SetIndexBuffer(s_Data.UnitQuadIndexBuffer);
+
+		// Text quads are still expanded on the CPU
+		uint32_t indexCount = s_Data.TextStream.Capacity / 4 * 6;
+		uint32_t* quadIndices = new uint32_t[indexCount];
 
 		uint32_t offset = 0;
-		for (uint32_t i = 0; i < s_Data.MaxIndices; i += 6)
+		for (uint32_t i = 0; i < indexCount; i += 6)
 		{
 			quadIndices[i + 0] = offset + 0;
 			quadIndices[i + 1] = offset + 1;
@@ -157,60 +383,149 @@ namespace Cobra {
 			offset += 4;
 		}
 
-		Ref<IndexBuffer> quadIB = IndexBuffer::Create(quadIndices, s_Data.MaxIndices);
-		s_Data.QuadVertexArray->SetIndexBuffer(quadIB);
+		Ref<IndexBuffer> quadIB = IndexBuffer::Create(quadIndices, indexCount);
 		delete[] quadIndices;
 
-		// Circles
-		s_Data.CircleVertexArray = VertexArray::Create();
+		s_Data.TextVertexArray = VertexArray::Create();
+		s_Data.TextVertexArray->AddVertexBuffer(s_Data.TextStream.Buffer);
+		s_Data.TextVertexArray->SetIndexBuffer(quadIB);
+	}
 
-		s_Data.CircleVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(CircleVertex));
-		s_Data.CircleVertexBuffer->SetLayout({
-			{ ShaderDataType::Float3, "a_WorldPosition" },
-			{ ShaderDataType::Float3, "a_LocalPosition" },
-			{ ShaderDataType::Float4, "a_Color"         },
-			{ ShaderDataType::Float,  "a_Thickness"     },
-			{ ShaderDataType::Float,  "a_Fade"          },
-			{ ShaderDataType::Int,    "a_EntityID"      }
-		});
-		s_Data.CircleVertexArray->AddVertexBuffer(s_Data.CircleVertexBuffer);
-		s_Data.CircleVertexArray->SetIndexBuffer(quadIB); // Use quad IB
-		s_Data.CircleVertexBufferBase = new CircleVertex[s_Data.MaxVertices];
-
-		// Lines
-		s_Data.LineVertexArray = VertexArray::Create();
-
-		s_Data.LineVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(LineVertex));
-		s_Data.LineVertexBuffer->SetLayout({
-			{ ShaderDataType::Float3, "a_Position" },
-			{ ShaderDataType::Float4, "a_Color"    },
-			{ ShaderDataType::Int,    "a_EntityID" }
-		});
-		s_Data.LineVertexArray->AddVertexBuffer(s_Data.LineVertexBuffer);
-		s_Data.LineVertexBufferBase = new LineVertex[s_Data.MaxVertices];
+	// A stream that did not fit a scene into a single region grows to fit it, so the next
+	// scene goes out in fewer draw calls. Growth stops at the stream's maximum capacity.
+	static void GrowStreams()
+	{
+		bool grown = false;
+		for (StreamCursor* stream : { &s_Data.QuadStream, &s_Data.CircleStream, &s_Data.TextStream })
+		{
+			uint32_t peak = stream->Emitted;
+			stream->Emitted = 0;
 
-		// Text
-		s_Data.TextVertexArray = VertexArray::Create();
+			if (peak <= stream->Capacity || stream->Capacity >= stream->MaxCapacity)
+				continue;
+
+			uint32_t capacity = stream->Capacity;
+			while (capacity < peak && capacity < stream->MaxCapacity)
+				capacity *= 2;
+			capacity = std::min(capacity, stream->MaxCapacity);
+
+			CB_CORE_INFO("Growing Renderer2D batch from {} to {} elements", stream->Capacity, capacity);
+			ResizeStream(*stream, capacity);
+			grown = true;
+		}
+
+		if (grown)
+			CreateVertexArrays();
+	}
+
+	static ShaderVariant GetShaderVariant(const std::string& filepath, std::vector<std::string> defines = {})
+	{
+		if (s_Data.Specification.EntityIDs)
+			defines.push_back("ENTITY_ID");
+
+		return { filepath, defines };
+	}
+
+	static Scope<SceneRecording> AcquireRecording()
+	{
+		{
+			std::scoped_lock<std::mutex> lock(s_Data.FreeRecordingMutex);
+			if (!s_Data.FreeRecordings.empty())
+			{
+				Scope<SceneRecording> recording = std::move(s_Data.FreeRecordings.back());
+				s_Data.FreeRecordings.pop_back();
+				return recording;
+			}
+		}
+
+		Scope<SceneRecording> recording = CreateScope<SceneRecording>();
+		recording->Contexts.push_back(CreateScope<RecordingContext>());
+		recording->Contexts[0]->Reset(s_Data.WhiteTexture);
+		return recording;
+	}
+
+	static void ReleaseRecording(Scope<SceneRecording> recording)
+	{
+		for (uint32_t i = 0; i < recording->ContextCount; i++)
+			recording->Contexts[i]->Reset(s_Data.WhiteTexture);
+		recording->ContextCount = 1;
+
+		std::scoped_lock<std::mutex> lock(s_Data.FreeRecordingMutex);
+		s_Data.FreeRecordings.push_back(std::move(recording));
+	}
+
+	void Renderer2D::Init(const RendererSpecification& specification)
+	{
+		CB_PROFILE_FUNCTION();
+
+		s_Data.Specification = specification;
+
+		// Shared unit quad, expanded per instance in the vertex shader
+		float unitQuadVertices[] = {
+			-0.5f, -0.5f,
+			 0.5f, -0.5f,
+			 0.5f,  0.5f,
+			-0.5f,  0.5f
+		};
 
-		s_Data.TextVertexBuffer = VertexBuffer::Create(s_Data.MaxVertices * sizeof(TextVertex));
-		s_Data.TextVertexBuffer->SetLayout({
-			{ ShaderDataType::Float3, "a_Position"     },
-			{ ShaderDataType::Float4, "a_Color"        },
-			{ ShaderDataType::Float2, "a_TexCoord"     },
-			{ ShaderDataType::Int,    "a_EntityID"     }
+		s_Data.UnitQuadVertexBuffer = VertexBuffer::Create(unitQuadVertices, sizeof(unitQuadVertices));
+		s_Data.UnitQuadVertexBuffer->SetLayout({
+			{ ShaderDataType::Float2, "a_LocalPosition" }
 		});
-		s_Data.TextVertexArray->AddVertexBuffer(s_Data.TextVertexBuffer);
-		s_Data.TextVertexArray->SetIndexBuffer(quadIB);
-		s_Data.TextVertexBufferBase = new TextVertex[s_Data.MaxVertices];
+
+		uint32_t unitQuadIndices[] = { 0, 1, 2, 2, 3, 0 };
+		s_Data.UnitQuadIndexBuffer = IndexBuffer::Create(unitQuadIndices, 6);
+
+		SetStreamLayout(s_Data.QuadStream, {
+			{ ShaderDataType::Float3,  "a_Position"           },
+			{ ShaderDataType::Float3,  "a_AxisX"              },
+			{ ShaderDataType::Float3,  "a_AxisY"              },
+			{ ShaderDataType::UByte4,  "a_Color",        true },
+			{ ShaderDataType::UShort4, "a_TexRect",      true },
+			{ ShaderDataType::Half,    "a_TilingFactor"       },
+			{ ShaderDataType::UByte,   "a_TexIndex"           },
+			{ ShaderDataType::UByte,   "a_Flags"              }
+		}, specification.QuadBatchCapacity);
+
+		SetStreamLayout(s_Data.CircleStream, {
+			{ ShaderDataType::Float3, "a_Position"            },
+			{ ShaderDataType::Float3, "a_AxisX"               },
+			{ ShaderDataType::Float3, "a_AxisY"               },
+			{ ShaderDataType::UByte4, "a_Color",         true },
+			{ ShaderDataType::Half2,  "a_ThicknessFade"       }
+		}, specification.UnifiedPipeline ? 1 : specification.CircleBatchCapacity);
+
+		SetStreamLayout(s_Data.TextStream, {
+			{ ShaderDataType::Float3,  "a_Position"       },
+			{ ShaderDataType::UByte4,  "a_Color",    true },
+			{ ShaderDataType::UShort2, "a_TexCoord", true },
+			{ ShaderDataType::UByte,   "a_TexIndex"       },
+			BufferElement::Padding(3)
+		}, specification.UnifiedPipeline ? 1 : specification.GlyphBatchCapacity, 4);
+
+		CreateVertexArrays();
 
 		s_Data.WhiteTexture = Texture2D::Create(TextureSpecification());
 		uint32_t whiteTextureData = 0xffffffff;
 		s_Data.WhiteTexture->SetData(Buffer(&whiteTextureData, sizeof(uint32_t)));
 
-		s_Data.QuadShader = Shader::Create("assets/shaders/Renderer2D_Quad.glsl");
-		s_Data.CircleShader = Shader::Create("assets/shaders/Renderer2D_Circle.glsl");
-		s_Data.LineShader = Shader::Create("assets/shaders/Renderer2D_Line.glsl");
-		s_Data.TextShader = Shader::Create("assets/shaders/Renderer2D_Text.glsl");
+		// Circles and text are drawn by the quad shader in the unified pipeline, their streams are left minimal
+		if (specification.UnifiedPipeline)
+		{
+			s_Data.QuadShader = Shader::Create({ GetShaderVariant("assets/shaders/Renderer2D_Quad.glsl", { "UNIFIED" }) })[0];
+		}
+		else
+		{
+			auto shaders = Shader::Create({
+				GetShaderVariant("assets/shaders/Renderer2D_Quad.glsl"),
+				GetShaderVariant("assets/shaders/Renderer2D_Circle.glsl"),
+				GetShaderVariant("assets/shaders/Renderer2D_Text.glsl")
+			});
+
+			s_Data.QuadShader = shaders[0];
+			s_Data.CircleShader = shaders[1];
+			s_Data.TextShader = shaders[2];
+		}
 
 		int32_t samplers[s_Data.MaxTextureSlots];
 		for (uint32_t i = 0; i < s_Data.MaxTextureSlots; i++)
@@ -218,6 +533,11 @@ namespace Cobra {
 
 		s_Data.TextureSlots[0] = s_Data.WhiteTexture;
 
+		if (specification.AtlasTextures)
+			s_Data.Atlas = CreateScope<TextureAtlas>(specification.AtlasPageSize, specification.MaxAtlasTextureSize);
+
+		s_Data.Recording = AcquireRecording();
+
 		s_Data.QuadVertexPositions[0] = { -0.5f, -0.5f, 0.0f, 1.0f };
 		s_Data.QuadVertexPositions[1] = { 0.5f, -0.5f, 0.0f, 1.0f };
 		s_Data.QuadVertexPositions[2] = { 0.5f,  0.5f, 0.0f, 1.0f };
@@ -229,14 +549,37 @@ namespace Cobra {
 	void Renderer2D::Shutdown()
 	{
 		CB_PROFILE_FUNCTION();
+
+		s_Data.TextLayouts.clear();
+		s_Data.PagingFonts.clear();
+		s_Data.Atlas.reset();
+
+		s_Data.Recording.reset();
+		s_Data.FreeRecordings.clear();
+	}
+
+	static void SetCamera(const glm::mat4& viewProjection)
+	{
+		s_Data.ViewProjection = viewProjection;
+		s_Data.ViewFrustum = Frustum(viewProjection);
+
+		// The viewport is set by whatever was bound before the scene, so it is queried in order with the other commands
+		RenderThread::Submit([viewProjection]()
+		{
+			uint32_t x, y, width, height;
+			RenderCommand::GetViewport(x, y, width, height);
+
+			s_Data.CameraBuffer.ViewProjection = viewProjection;
+			s_Data.CameraBuffer.ViewportSize = { (float)width, (float)height };
+			s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
+		});
 	}
 
 	void Renderer2D::BeginScene(const Camera& camera, const glm::mat4& transform)
 	{
 		CB_PROFILE_FUNCTION();
 
-		s_Data.CameraBuffer.ViewProjection = camera.GetProjection() * glm::inverse(transform);
-		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
+		SetCamera(camera.GetProjection() * glm::inverse(transform));
 
 		StartBatch();
 	}
@@ -245,8 +588,7 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		s_Data.CameraBuffer.ViewProjection = camera.GetViewProjection();
-		s_Data.CameraUniformBuffer->SetData(&s_Data.CameraBuffer, sizeof(Renderer2DData::CameraData));
+		SetCamera(camera.GetViewProjection());
 
 		StartBatch();
 	}
@@ -255,8 +597,7 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		s_Data.QuadShader->Bind();
-		s_Data.QuadShader->SetMat4("u_ViewProjection", camera.GetViewProjectionMatrix());
+		SetCamera(camera.GetViewProjectionMatrix());
 
 		StartBatch();
 	}
@@ -266,56 +607,320 @@ namespace Cobra {
 		CB_PROFILE_FUNCTION();
 
 		Flush();
+
+		// Nothing is recording between scenes, so layouts can safely be evicted, and fonts and the atlas can add to their pages here.
+		// Their uploads are recorded after the flush, so they only reach the next scene.
+		if (s_Data.Atlas)
+			s_Data.Atlas->Update();
+
+		{
+			std::scoped_lock<std::mutex> lock(s_Data.PagingFontMutex);
+
+			auto it = std::remove_if(s_Data.PagingFonts.begin(), s_Data.PagingFonts.end(), [](const Ref<Font>& font) { return !font->UpdateGlyphPages(); });
+			s_Data.PagingFonts.erase(it, s_Data.PagingFonts.end());
+		}
+
+		s_Data.SceneIndex++;
+		if (s_Data.SceneIndex % 64 == 0)
+		{
+			for (auto it = s_Data.TextLayouts.begin(); it != s_Data.TextLayouts.end();)
+			{
+				if (s_Data.SceneIndex - it->second->LastUsedScene > s_Data.TextLayoutLifetime)
+					it = s_Data.TextLayouts.erase(it);
+				else
+					++it;
+			}
+		}
 	}
 
-	void Renderer2D::Flush()
+	// Maps clip space depth to [0, 1] with 0 at the far plane, so farther primitives sort first
+	static float GetSortDepth(const glm::vec3& position)
+	{
+		glm::vec4 clip = s_Data.ViewProjection * glm::vec4(position, 1.0f);
+		if (clip.w <= 0.0f)
+			return 0.0f;
+
+		return 0.5f - 0.5f * (clip.z / clip.w);
+	}
+
+	static RecordingContext& GetRecordingContext()
 	{
-		if (s_Data.QuadIndexCount)
+		return t_RecordingContext ? *t_RecordingContext : *s_Data.Recording->Contexts[0];
+	}
+
+	static void Submit(RecordingContext& context, PrimitiveType type, const glm::vec3& position, uint32_t texture, int entityID, uint32_t index)
+	{
+		CB_CORE_ASSERT(index <= s_Data.PayloadIndexMask, "Too many primitives recorded in one context!");
+
+		uint64_t key = RenderQueue::MakeKey(s_Data.Layer, GetSortDepth(position), (uint32_t)type, texture, entityID);
+		context.Queue.Submit(key, index);
+	}
+
+	static uint32_t GetContextTextureIndex(RecordingContext& context, const Ref<Texture2D>& texture)
+	{
+		auto it = context.TextureIndices.find(texture->GetRendererID());
+		if (it != context.TextureIndices.end())
+			return it->second;
+
+		uint32_t index = (uint32_t)context.Textures.size();
+		context.Textures.push_back(texture);
+		context.TextureIndices[texture->GetRendererID()] = index;
+		return index;
+	}
+
+	static uint32_t GetSceneTextureIndex(const Ref<Texture2D>& texture)
+	{
+		auto it = s_Data.SceneTextureIndices.find(texture->GetRendererID());
+		if (it != s_Data.SceneTextureIndices.end())
+			return it->second;
+
+		uint32_t index = (uint32_t)s_Data.SceneTextures.size();
+		s_Data.SceneTextures.push_back(texture);
+		s_Data.SceneTextureIndices[texture->GetRendererID()] = index;
+		return index;
+	}
+
+	// Resolves every context's textures and payload indices into the scene wide queue
+	static void MergeRecordingContexts()
+	{
+		CB_PROFILE_FUNCTION();
+
+		const SceneRecording& recording = *s_Data.FlushedRecording;
+
+		uint32_t commandCount = 0;
+		for (uint32_t i = 0; i < recording.ContextCount; i++)
+			commandCount += recording.Contexts[i]->Queue.GetCount();
+
+		s_Data.Queue.Clear();
+		s_Data.Queue.Reserve(commandCount);
+
+		s_Data.SceneTextures.clear();
+		s_Data.SceneTextureIndices.clear();
+
+		for (uint32_t i = 0; i < recording.ContextCount; i++)
 		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.QuadVertexBufferPtr - (uint8_t*)s_Data.QuadVertexBufferBase);
-			s_Data.QuadVertexBuffer->SetData(s_Data.QuadVertexBufferBase, dataSize);
+			RecordingContext& context = *recording.Contexts[i];
+
+			context.TextureRemap.resize(context.Textures.size());
+			for (size_t t = 0; t < context.Textures.size(); t++)
+				context.TextureRemap[t] = GetSceneTextureIndex(context.Textures[t]);
 
-			// Bind textures
-			for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
-				s_Data.TextureSlots[i]->Bind(i);
+			for (const RenderQueue::Command& command : context.Queue)
+			{
+				uint64_t key = command.Key;
+				uint32_t texture = RenderQueue::GetTexture(key);
+				if (texture < context.TextureRemap.size())
+					key = RenderQueue::SetTexture(key, context.TextureRemap[texture]);
 
-			s_Data.QuadShader->Bind();
-			RenderCommand::DrawIndexed(s_Data.QuadVertexArray, s_Data.QuadIndexCount);
-			s_Data.Stats.DrawCalls++;
+				s_Data.Queue.Submit(key, (context.Index << s_Data.PayloadIndexBits) | command.Index);
+			}
+
+			s_Data.Stats.QuadCount += context.QuadCount;
 		}
 
-		if (s_Data.CircleIndexCount)
-		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.CircleVertexBufferPtr - (uint8_t*)s_Data.CircleVertexBufferBase);
-			s_Data.CircleVertexBuffer->SetData(s_Data.CircleVertexBufferBase, dataSize);
+		s_Data.SceneTextureSlots.assign(s_Data.SceneTextures.size(), 0);
+	}
+
+	static void FlushQuadRun()
+	{
+		uint32_t count = s_Data.QuadStream.GetRunCount();
+		if (!count)
+			return;
 
-			s_Data.CircleShader->Bind();
-			RenderCommand::DrawIndexed(s_Data.CircleVertexArray, s_Data.CircleIndexCount);
-			s_Data.Stats.DrawCalls++;
+		for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
+			s_Data.TextureSlots[i]->Bind(i);
+
+		s_Data.QuadShader->Bind();
+		RenderCommand::DrawIndexedInstanced(s_Data.QuadVertexArray, 6, count, s_Data.QuadStream.GetRunOffset());
+		s_Data.QuadStream.RunStart = s_Data.QuadStream.Ptr;
+		s_Data.Stats.DrawCalls++;
+	}
+
+	static void FlushCircleRun()
+	{
+		uint32_t count = s_Data.CircleStream.GetRunCount();
+		if (!count)
+			return;
+
+		s_Data.CircleShader->Bind();
+		RenderCommand::DrawIndexedInstanced(s_Data.CircleVertexArray, 6, count, s_Data.CircleStream.GetRunOffset());
+		s_Data.CircleStream.RunStart = s_Data.CircleStream.Ptr;
+		s_Data.Stats.DrawCalls++;
+	}
+
+	static void FlushTextRun()
+	{
+		uint32_t count = s_Data.TextStream.GetRunCount();
+		if (!count)
+			return;
+
+		for (uint32_t i = 0; i < s_Data.TextureSlotIndex; i++)
+			s_Data.TextureSlots[i]->Bind(i);
+
+		s_Data.TextShader->Bind();
+		RenderCommand::DrawIndexed(s_Data.TextVertexArray, count / 4 * 6, s_Data.TextStream.GetRunOffset());
+		s_Data.TextStream.RunStart = s_Data.TextStream.Ptr;
+		s_Data.Stats.DrawCalls++;
+	}
+
+	static void FlushRun(PrimitiveType type)
+	{
+		switch (type)
+		{
+			case PrimitiveType::Quad:        FlushQuadRun(); break;
+			case PrimitiveType::Circle:      FlushCircleRun(); break;
+			case PrimitiveType::Text:        FlushTextRun(); break;
+			case PrimitiveType::StaticQuads: break; // Drawn as they are emitted
 		}
+	}
+
+	// Moves on to the next region once the current one is full
+	static void EnsureRoom(StreamCursor& stream, uint32_t count, void(*flushRun)())
+	{
+		if (stream.HasRoom(count))
+			return;
+
+		flushRun();
+		stream.End();
+		stream.Begin();
+	}
 
-		if (s_Data.LineVertexCount)
+	// Sprite textures and font atlases share the slots. Only one run is open at a time and a
+	// run binds the slots when it is flushed, so the open run is flushed before they are reused.
+	static uint32_t GetTextureSlot(uint32_t sceneTexture, void(*flushRun)())
+	{
+		if (sceneTexture != 0 && s_Data.SceneTextureSlots[sceneTexture] == 0)
 		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.LineVertexBufferPtr - (uint8_t*)s_Data.LineVertexBufferBase);
-			s_Data.LineVertexBuffer->SetData(s_Data.LineVertexBufferBase, dataSize);
+			if (s_Data.TextureSlotIndex >= s_Data.MaxTextureSlots)
+			{
+				flushRun();
 
-			s_Data.LineShader->Bind();
-			RenderCommand::SetLineWidth(s_Data.LineWidth);
-			RenderCommand::DrawLines(s_Data.LineVertexArray, s_Data.LineVertexCount);
-			s_Data.Stats.DrawCalls++;
+				for (uint32_t i = 1; i < s_Data.TextureSlotIndex; i++)
+					s_Data.SceneTextureSlots[s_Data.TextureSlotSceneIndices[i]] = 0;
+				s_Data.TextureSlotIndex = 1;
+			}
+
+			s_Data.SceneTextureSlots[sceneTexture] = s_Data.TextureSlotIndex;
+			s_Data.TextureSlots[s_Data.TextureSlotIndex] = s_Data.SceneTextures[sceneTexture];
+			s_Data.TextureSlotSceneIndices[s_Data.TextureSlotIndex] = sceneTexture;
+			s_Data.TextureSlotIndex++;
 		}
 
-		if (s_Data.TextIndexCount)
+		return s_Data.SceneTextureSlots[sceneTexture];
+	}
+
+	static void EmitQuad(uint32_t index)
+	{
+		EnsureRoom(s_Data.QuadStream, 1, FlushQuadRun);
+
+		const RecordingContext& context = *s_Data.FlushedRecording->Contexts[index >> s_Data.PayloadIndexBits];
+		const QuadPayload& quad = context.QuadPayloads[index & s_Data.PayloadIndexMask];
+
+		QuadInstance instance = quad.Instance;
+		instance.TexIndex = (uint8_t)GetTextureSlot(context.TextureRemap[quad.Texture], FlushQuadRun);
+		s_Data.QuadStream.Push(&instance);
+	}
+
+	static void EmitCircle(uint32_t index)
+	{
+		EnsureRoom(s_Data.CircleStream, 1, FlushCircleRun);
+
+		const RecordingContext& context = *s_Data.FlushedRecording->Contexts[index >> s_Data.PayloadIndexBits];
+		s_Data.CircleStream.Push(&context.CirclePayloads[index & s_Data.PayloadIndexMask]);
+	}
+
+	static void EmitGlyph(uint32_t index)
+	{
+		EnsureRoom(s_Data.TextStream, 4, FlushTextRun);
+
+		const RecordingContext& context = *s_Data.FlushedRecording->Contexts[index >> s_Data.PayloadIndexBits];
+		const GlyphPayload& glyph = context.GlyphPayloads[index & s_Data.PayloadIndexMask];
+
+		uint8_t slot = (uint8_t)GetTextureSlot(context.TextureRemap[glyph.FontAtlas], FlushTextRun);
+		for (uint32_t i = 0; i < 4; i++)
+		{
+			TextVertex vertex = glyph.Vertices[i];
+			vertex.TexIndex = slot;
+			s_Data.TextStream.Push(&vertex);
+		}
+	}
+
+	static void EmitStaticBatch(uint32_t index)
+	{
+		const RecordingContext& context = *s_Data.FlushedRecording->Contexts[index >> s_Data.PayloadIndexBits];
+		const StaticBatchPayload& payload = context.StaticBatchPayloads[index & s_Data.PayloadIndexMask];
+		const Ref<StaticQuadBatch>& batch = payload.Batch;
+
+		// Baked with texture index 1, the quad run rebinds its own slots when it is flushed
+		s_Data.WhiteTexture->Bind(0);
+		if (payload.Texture)
+			payload.Texture->Bind(1);
+
+		s_Data.QuadShader->Bind();
+		RenderCommand::DrawIndexedInstanced(batch->GetVertexArray(), 6, payload.Count);
+		s_Data.Stats.DrawCalls++;
+	}
+
+	static void FlushRecording(const SceneRecording& recording)
+	{
+		CB_PROFILE_FUNCTION();
+
+		s_Data.FlushedRecording = &recording;
+		s_Data.TextureSlotIndex = 1;
+
+		MergeRecordingContexts();
+		if (s_Data.Queue.IsEmpty())
 		{
-			uint32_t dataSize = (uint32_t)((uint8_t*)s_Data.TextVertexBufferPtr - (uint8_t*)s_Data.TextVertexBufferBase);
-			s_Data.TextVertexBuffer->SetData(s_Data.TextVertexBufferBase, dataSize);
+			s_Data.FlushedRecording = nullptr;
+			return;
+		}
+
+		s_Data.Queue.Sort();
 
-			s_Data.FontAtlasTexture->Bind(0);
+		s_Data.QuadStream.Begin();
+		s_Data.CircleStream.Begin();
+		s_Data.TextStream.Begin();
 
-			s_Data.TextShader->Bind();
-			RenderCommand::DrawIndexed(s_Data.TextVertexArray, s_Data.TextIndexCount);
-			s_Data.Stats.DrawCalls++;
+		// Consecutive commands of the same primitive type go out as a single draw call
+		PrimitiveType currentType = PrimitiveType::Quad;
+		for (const RenderQueue::Command& command : s_Data.Queue)
+		{
+			PrimitiveType type = (PrimitiveType)RenderQueue::GetShader(command.Key);
+			if (type != currentType)
+			{
+				FlushRun(currentType);
+				currentType = type;
+			}
+
+			switch (type)
+			{
+				case PrimitiveType::Quad:        EmitQuad(command.Index); break;
+				case PrimitiveType::Circle:      EmitCircle(command.Index); break;
+				case PrimitiveType::Text:        EmitGlyph(command.Index); break;
+				case PrimitiveType::StaticQuads: EmitStaticBatch(command.Index); break;
+			}
 		}
+		FlushRun(currentType);
+
+		s_Data.QuadStream.End();
+		s_Data.CircleStream.End();
+		s_Data.TextStream.End();
+
+		GrowStreams();
+		s_Data.FlushedRecording = nullptr;
+	}
+
+	void Renderer2D::Flush()
+	{
+		CB_PROFILE_FUNCTION();
+
+		RenderThread::Submit([recording = std::move(s_Data.Recording)]() mutable
+		{
+			FlushRecording(*recording);
+			ReleaseRecording(std::move(recording));
+		});
+
+		s_Data.Recording = AcquireRecording();
 	}
 
 	void Renderer2D::DrawQuad(const glm::vec2& position, const glm::vec2& size, const glm::vec4& color)
@@ -352,27 +957,16 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		constexpr uint32_t quadVertexCount = 4;
-		const float textureIndex = 0.0f;
-		constexpr glm::vec2 textureCoords[] = { {0.0f, 0.0f}, {1.0f, 0.0f}, {1.0f, 1.0f}, {0.0f, 1.0f} };
+		const uint32_t textureIndex = 0;
 		const float tilingFactor = 1.0f;
 
-		if (s_Data.QuadIndexCount >= s_Data.MaxIndices)
-			NextBatch();
-		
-		for (uint32_t i = 0; i < quadVertexCount; i++)
-		{
-			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr->Color = color;
-			s_Data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-			s_Data.QuadVertexBufferPtr->TexIndex = textureIndex;
-			s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-			s_Data.QuadVertexBufferPtr->EntityID = entityID;
-			s_Data.QuadVertexBufferPtr++;
-		}
+		RecordingContext& context = GetRecordingContext();
+		QuadPayload& quad = context.QuadPayloads.emplace_back();
+		FillQuadInstance(quad.Instance, transform, color, tilingFactor, entityID);
+		quad.Texture = textureIndex;
 
-		s_Data.QuadIndexCount += 6;
-		s_Data.Stats.QuadCount++;
+		Submit(context, PrimitiveType::Quad, quad.Instance.Position, textureIndex, entityID, (uint32_t)context.QuadPayloads.size() - 1);
+		context.QuadCount++;
 	}
 
 	void Renderer2D::DrawQuad(const glm::mat4& transform, const Ref<Texture2D>& texture, float tilingFactor, const glm::vec4& tintColor, int entityID)
@@ -380,45 +974,29 @@ namespace Cobra {
 		CB_PROFILE_FUNCTION();
 		CB_CORE_VERIFY(texture);
 
-		constexpr uint32_t quadVertexCount = 4;
-		constexpr glm::vec2 textureCoords[] = { { 0.0f, 0.0f }, { 1.0f, 0.0f }, { 1.0f, 1.0f }, { 0.0f, 1.0f } };
+		// Small textures are drawn from their atlas page once they are packed. Tiling relies on
+		// the texture repeating, which a region of a page does not.
+		TextureAtlasRegion region;
+		bool atlased = s_Data.Atlas && tilingFactor == 1.0f && s_Data.Atlas->GetRegion(texture, region);
 
-		if (s_Data.QuadIndexCount >= s_Data.MaxIndices)
-			NextBatch();
+		// Texture slots are only assigned once the sorted queue is batched
+		RecordingContext& context = GetRecordingContext();
+		uint32_t textureIndex = GetContextTextureIndex(context, atlased ? region.Page : texture);
 
-		float textureIndex = 0.0f;
-		for (uint32_t i = 1; i < s_Data.TextureSlotIndex; i++)
-		{
-			if (*s_Data.TextureSlots[i] == *texture)
-			{
-				textureIndex = (float)i;
-				break;
-			}
-		}
+		QuadPayload& quad = context.QuadPayloads.emplace_back();
+		FillQuadInstance(quad.Instance, transform, tintColor, tilingFactor, entityID);
+		quad.Texture = textureIndex;
 
-		if (textureIndex == 0.0f)
+		if (atlased)
 		{
-			if (s_Data.TextureSlotIndex >= s_Data.MaxTextureSlots)
-				NextBatch();
-
-			textureIndex = (float)s_Data.TextureSlotIndex;
-			s_Data.TextureSlots[(uint32_t)s_Data.TextureSlotIndex] = texture;
-			s_Data.TextureSlotIndex++;
+			quad.Instance.TexRect[0] = glm::packUnorm1x16(region.UVMin.x);
+			quad.Instance.TexRect[1] = glm::packUnorm1x16(region.UVMin.y);
+			quad.Instance.TexRect[2] = glm::packUnorm1x16(region.UVMax.x);
+			quad.Instance.TexRect[3] = glm::packUnorm1x16(region.UVMax.y);
 		}
 
-		for (uint32_t i = 0; i < quadVertexCount; i++)
-		{
-			s_Data.QuadVertexBufferPtr->Position = transform * s_Data.QuadVertexPositions[i];
-			s_Data.QuadVertexBufferPtr->Color = tintColor;
-			s_Data.QuadVertexBufferPtr->TexCoord = textureCoords[i];
-			s_Data.QuadVertexBufferPtr->TexIndex = textureIndex;
-			s_Data.QuadVertexBufferPtr->TilingFactor = tilingFactor;
-			s_Data.QuadVertexBufferPtr->EntityID = entityID;
-			s_Data.QuadVertexBufferPtr++;
-		}
-
-		s_Data.QuadIndexCount += 6;
-		s_Data.Stats.QuadCount++;
+		Submit(context, PrimitiveType::Quad, quad.Instance.Position, textureIndex, entityID, (uint32_t)context.QuadPayloads.size() - 1);
+		context.QuadCount++;
 	}
 
 	void Renderer2D::DrawRotatedQuad(const glm::vec2& position, const glm::vec2& size, float rotation, const glm::vec4& color)
@@ -457,38 +1035,58 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		// TODO: implement for cicles
-		//if (s_Data.QuadIndexCount >= s_Data.MaxIndices)
-		//	NextBatch();
+		RecordingContext& context = GetRecordingContext();
 
-		for (uint32_t i = 0; i < 4; i++)
+		if (s_Data.Specification.UnifiedPipeline)
 		{
-			s_Data.CircleVertexBufferPtr->WorldPosition = transform * s_Data.QuadVertexPositions[i];
-			s_Data.CircleVertexBufferPtr->LocalPosition = s_Data.QuadVertexPositions[i] * 2.0f;
-			s_Data.CircleVertexBufferPtr->Color = color;
-			s_Data.CircleVertexBufferPtr->Thickness = thickness;
-			s_Data.CircleVertexBufferPtr->Fade = fade;
-			s_Data.CircleVertexBufferPtr->EntityID = entityID;
-			s_Data.CircleVertexBufferPtr++;
+			QuadPayload& circle = context.QuadPayloads.emplace_back();
+			FillQuadInstance(circle.Instance, transform, color, 1.0f, entityID);
+			circle.Instance.TexRect[0] = glm::packUnorm1x16(thickness);
+			circle.Instance.TexRect[1] = glm::packUnorm1x16(fade);
+			circle.Instance.Flags = QuadInstanceCircle;
+			circle.Texture = 0;
+
+			Submit(context, PrimitiveType::Quad, circle.Instance.Position, 0, entityID, (uint32_t)context.QuadPayloads.size() - 1);
+			context.QuadCount++;
+			return;
 		}
 
-		s_Data.CircleIndexCount += 6;
-		s_Data.Stats.QuadCount++;
+		CircleInstance& instance = context.CirclePayloads.emplace_back();
+		instance.Position = transform[3];
+		instance.AxisX = transform[0];
+		instance.AxisY = transform[1];
+		instance.Color = PackColor(color);
+		instance.ThicknessFade = glm::packHalf2x16({ thickness, fade });
+		instance.EntityID = entityID;
+
+		Submit(context, PrimitiveType::Circle, instance.Position, 0, entityID, (uint32_t)context.CirclePayloads.size() - 1);
+		context.QuadCount++;
 	}
 
 	void Renderer2D::DrawLine(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color, int entityID)
 	{
-		s_Data.LineVertexBufferPtr->Position = p0;
-		s_Data.LineVertexBufferPtr->Color = color;
-		s_Data.LineVertexBufferPtr->EntityID = entityID;
-		s_Data.LineVertexBufferPtr++;
-
-		s_Data.LineVertexBufferPtr->Position = p1;
-		s_Data.LineVertexBufferPtr->Color = color;
-		s_Data.LineVertexBufferPtr->EntityID = entityID;
-		s_Data.LineVertexBufferPtr++;
+		DrawLine(p0, p1, color, s_Data.LineWidth, entityID);
+	}
 
-		s_Data.LineVertexCount += 2;
+	void Renderer2D::DrawLine(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color, float width, int entityID)
+	{
+		RecordingContext& context = GetRecordingContext();
+		QuadPayload& line = context.QuadPayloads.emplace_back();
+		line.Texture = 0;
+
+		// Batched with untextured quads
+		QuadInstance& instance = line.Instance;
+		instance.Position = p0;
+		instance.AxisX = p1 - p0;
+		instance.AxisY = glm::vec3(0.0f);
+		instance.Color = PackColor(color);
+		instance.TexRect[0] = instance.TexRect[1] = instance.TexRect[2] = instance.TexRect[3] = 0;
+		instance.TilingFactor = glm::packHalf1x16(width);
+		instance.TexIndex = 0;
+		instance.Flags = QuadInstanceLine;
+		instance.EntityID = entityID;
+
+		Submit(context, PrimitiveType::Quad, (p0 + p1) * 0.5f, 0, entityID, (uint32_t)context.QuadPayloads.size() - 1);
 	}
 
 	void Renderer2D::DrawRect(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, int entityID)
@@ -521,6 +1119,12 @@ namespace Cobra {
 		if (src.Texture)
 		{
 			Ref<Texture2D> texture = AssetManager::GetAsset<Texture2D>(src.Texture);
+			CB_CORE_VERIFY(texture);
+
+			// Still being uploaded
+			if (!texture->IsLoaded())
+				return;
+
 			DrawQuad(transform, texture, src.TilingFactor, src.Color, entityID);
 		}
 		else
@@ -529,116 +1133,266 @@ namespace Cobra {
 		}
 	}
 
-	void Renderer2D::DrawString(const std::string& string, Ref<Font> font, const glm::mat4& transform, const TextParams& textParams, int entityID)
+	void Renderer2D::DrawStaticBatch(const Ref<StaticQuadBatch>& batch)
 	{
-		const auto& fontGeometry = font->GetMSDFData()->FontGeometry;
-		const auto& metrics = fontGeometry.getMetrics();
-		Ref<Texture2D> fontAtlas = font->GetAtlasTexture();
+		if (!batch->GetCount() || (batch->GetTexture() && !batch->GetTexture()->IsLoaded()))
+			return;
+
+		RecordingContext& context = GetRecordingContext();
+		uint32_t textureIndex = batch->GetTexture() ? GetContextTextureIndex(context, batch->GetTexture()) : 0;
+		context.StaticBatchPayloads.push_back({ batch, batch->GetTexture(), batch->GetCount() });
+
+		glm::vec3 center = (batch->GetBoundsMin() + batch->GetBoundsMax()) * 0.5f;
+		Submit(context, PrimitiveType::StaticQuads, center, textureIndex, -1, (uint32_t)context.StaticBatchPayloads.size() - 1);
+		context.QuadCount += batch->GetCount();
+	}
 
-		s_Data.FontAtlasTexture = fontAtlas;
+	// Returns the codepoint starting at string[i] and moves i past it, malformed sequences decode to U+FFFD
+	static uint32_t DecodeUTF8(const std::string& string, size_t& i)
+	{
+		uint8_t lead = (uint8_t)string[i++];
+		if (lead < 0x80)
+			return lead;
+
+		uint32_t length = (lead & 0xE0) == 0xC0 ? 1 : (lead & 0xF0) == 0xE0 ? 2 : (lead & 0xF8) == 0xF0 ? 3 : 0;
+		if (length == 0 || i + length > string.size())
+			return 0xFFFD;
+
+		uint32_t codepoint = lead & (0x3F >> length);
+		for (uint32_t j = 0; j < length; j++)
+		{
+			uint8_t continuation = (uint8_t)string[i];
+			if ((continuation & 0xC0) != 0x80)
+				return 0xFFFD;
+
+			codepoint = (codepoint << 6) | (continuation & 0x3F);
+			i++;
+		}
+
+		return codepoint;
+	}
+
+	// Glyphs the font has not generated yet are requested here, the font is updated at the end of the scene
+	static const FontGlyph* GetOrRequestGlyph(const Ref<Font>& font, uint32_t codepoint)
+	{
+		const FontGlyph* glyph = font->GetGlyph(codepoint);
+		if (!glyph && font->RequestGlyph(codepoint))
+		{
+			std::scoped_lock<std::mutex> lock(s_Data.PagingFontMutex);
+			if (std::find(s_Data.PagingFonts.begin(), s_Data.PagingFonts.end(), font) == s_Data.PagingFonts.end())
+				s_Data.PagingFonts.push_back(font);
+		}
+
+		return glyph;
+	}
+
+	// Walks the glyph quads of a string in font space, calling func(glyph, quadMin, quadMax).
+	// Returns false if some glyphs are still being generated and were left out.
+	template<typename Func>
+	static bool LayoutString(const std::string& string, const Ref<Font>& font, const Renderer2D::TextParams& textParams, Func&& func)
+	{
+		const auto& metrics = font->GetMSDFData()->FontGeometry.getMetrics();
 
 		double x = 0.0;
 		double fsScale = 1.0 / (metrics.ascenderY - metrics.descenderY);
 		double y = 0.0;
 
-		const float spaceGlyphAdvance = fontGeometry.getGlyph(' ')->getAdvance();
+		const FontGlyph* spaceGlyph = font->GetGlyph(' ');
+		const float spaceGlyphAdvance = spaceGlyph ? spaceGlyph->Advance : 0.0f;
 
-		for (size_t i = 0; i < string.size(); i++)
+		std::vector<uint32_t> codepoints;
+		codepoints.reserve(string.size());
+		for (size_t i = 0; i < string.size();)
+			codepoints.push_back(DecodeUTF8(string, i));
+
+		bool complete = true;
+		for (size_t i = 0; i < codepoints.size(); i++)
 		{
-			char character = string[i];
+			uint32_t codepoint = codepoints[i];
 
-			if (character == '\r') continue;
-			if (character == '\n')
+			if (codepoint == '\r') continue;
+			if (codepoint == '\n')
 			{
 				x = 0;
 				y -= fsScale * metrics.lineHeight + textParams.LineSpacing;
 				continue;
 			}
 
-			if (character == ' ')
+			if (codepoint == ' ')
 			{
 				float advance = spaceGlyphAdvance;
-				if (i < string.size() - 1)
-				{
-					char nextCharacter = string[i + 1];
-					double dAdvance;
-
-					fontGeometry.getAdvance(dAdvance, character, nextCharacter);
-					advance = (float)dAdvance;
-				}
+				if (i < codepoints.size() - 1)
+					advance = font->GetAdvance(codepoint, codepoints[i + 1]);
 
 				x += fsScale * advance + textParams.Kerning;
 				continue;
 			}
 
-			if (character == '\t')
+			if (codepoint == '\t')
 			{
 				x += (fsScale * spaceGlyphAdvance + textParams.Kerning) * 4.0f;
 				continue;
 			}
 
-			auto glyph = fontGeometry.getGlyph(character);
-			if (!glyph)
-				glyph = fontGeometry.getGlyph('?');
+			// Left as a gap until it has been generated
+			const FontGlyph* glyph = GetOrRequestGlyph(font, codepoint);
 			if (!glyph)
-				return;
-
-			double al, ab, ar, at;
-			glyph->getQuadAtlasBounds(al, ab, ar, at);
-			glm::vec2 texCoordMin((float)al, (float)ab);
-			glm::vec2 texCoordMax((float)ar, (float)at);
-
-			double pl, pb, pr, pt;
-			glyph->getQuadPlaneBounds(pl, pb, pr, pt);
-			glm::vec2 quadMin((float)pl, (float)pb);
-			glm::vec2 quadMax((float)pr, (float)pt);
-
-			quadMin *= fsScale, quadMax *= fsScale;
-			quadMin += glm::vec2(x, y);
-			quadMax += glm::vec2(x, y);
-
-			float texelWidth = 1.0f / fontAtlas->GetWidth();
-			float texelHeight = 1.0f / fontAtlas->GetHeight();
-			texCoordMin *= glm::vec2(texelWidth, texelHeight);
-			texCoordMax *= glm::vec2(texelWidth, texelHeight);
-
-			// render here
-			s_Data.TextVertexBufferPtr->Position = transform * glm::vec4(quadMin, 0.0f, 1.0f);
-			s_Data.TextVertexBufferPtr->Color = textParams.Color;
-			s_Data.TextVertexBufferPtr->TexCoord = texCoordMin;
-			s_Data.TextVertexBufferPtr->EntityID = entityID;
-			s_Data.TextVertexBufferPtr++;
-
-			s_Data.TextVertexBufferPtr->Position = transform * glm::vec4(quadMin.x, quadMax.y, 0.0f, 1.0f);
-			s_Data.TextVertexBufferPtr->Color = textParams.Color;
-			s_Data.TextVertexBufferPtr->TexCoord = { texCoordMin.x, texCoordMax.y };
-			s_Data.TextVertexBufferPtr->EntityID = entityID;
-			s_Data.TextVertexBufferPtr++;
-
-			s_Data.TextVertexBufferPtr->Position = transform * glm::vec4(quadMax, 0.0f, 1.0f);
-			s_Data.TextVertexBufferPtr->Color = textParams.Color;
-			s_Data.TextVertexBufferPtr->TexCoord = texCoordMax;
-			s_Data.TextVertexBufferPtr->EntityID = entityID;
-			s_Data.TextVertexBufferPtr++;
-
-			s_Data.TextVertexBufferPtr->Position = transform * glm::vec4(quadMax.x, quadMin.y, 0.0f, 1.0f);
-			s_Data.TextVertexBufferPtr->Color = textParams.Color;
-			s_Data.TextVertexBufferPtr->TexCoord = { texCoordMax.x, texCoordMin.y };
-			s_Data.TextVertexBufferPtr->EntityID = entityID;
-			s_Data.TextVertexBufferPtr++;
-
-			s_Data.TextIndexCount += 6;
-			s_Data.Stats.QuadCount++;
-
-			if (i < string.size() - 1)
 			{
-				double advance = glyph->getAdvance();
-				char nextCharacter = string[i + 1];
-				fontGeometry.getAdvance(advance, character, nextCharacter);
+				complete = false;
+				x += fsScale * spaceGlyphAdvance + textParams.Kerning;
+				continue;
+			}
 
+			glm::vec2 quadMin = glyph->QuadMin * (float)fsScale + glm::vec2(x, y);
+			glm::vec2 quadMax = glyph->QuadMax * (float)fsScale + glm::vec2(x, y);
+
+			func(*glyph, quadMin, quadMax);
+
+			if (i < codepoints.size() - 1)
+			{
+				double advance = font->GetAdvance(codepoint, codepoints[i + 1]);
 				x += fsScale * advance + textParams.Kerning;
 			}
 		}
+
+		return complete;
+	}
+
+	static size_t HashTextLayout(const std::string& string, const Ref<Font>& font, float kerning, float lineSpacing)
+	{
+		size_t hash = std::hash<std::string>()(string);
+		for (size_t value : { std::hash<const void*>()(font.get()), std::hash<float>()(kerning), std::hash<float>()(lineSpacing) })
+			hash ^= value + 0x9e3779b9 + (hash << 6) + (hash >> 2);
+
+		return hash;
+	}
+
+	// The returned layout stays valid until the current scene ends
+	static const TextLayout& GetTextLayout(const std::string& string, const Ref<Font>& font, const Renderer2D::TextParams& textParams)
+	{
+		size_t hash = HashTextLayout(string, font, textParams.Kerning, textParams.LineSpacing);
+
+		{
+			std::shared_lock<std::shared_mutex> lock(s_Data.TextLayoutMutex);
+
+			auto [begin, end] = s_Data.TextLayouts.equal_range(hash);
+			for (auto it = begin; it != end; ++it)
+			{
+				if (it->second->Matches(string, font, textParams.Kerning, textParams.LineSpacing))
+				{
+					it->second->LastUsedScene = s_Data.SceneIndex;
+					return *it->second;
+				}
+			}
+		}
+
+		CB_PROFILE_FUNCTION();
+
+		Scope<TextLayout> layout = CreateScope<TextLayout>();
+		layout->String = string;
+		layout->FontAsset = font;
+		layout->Kerning = textParams.Kerning;
+		layout->LineSpacing = textParams.LineSpacing;
+		layout->FontGlyphVersion = font->GetGlyphVersion();
+		layout->LastUsedScene = s_Data.SceneIndex;
+
+		layout->BoundsMin = glm::vec2(std::numeric_limits<float>::max());
+		layout->BoundsMax = glm::vec2(std::numeric_limits<float>::lowest());
+
+		layout->Complete = LayoutString(string, font, textParams, [&](const FontGlyph& fontGlyph, const glm::vec2& quadMin, const glm::vec2& quadMax)
+		{
+			const glm::vec2& texCoordMin = fontGlyph.TexCoordMin;
+			const glm::vec2& texCoordMax = fontGlyph.TexCoordMax;
+
+			TextLayout::Glyph& glyph = layout->Glyphs.emplace_back();
+			glyph.QuadMin = quadMin;
+			glyph.QuadMax = quadMax;
+			glyph.TexCoords[0] = glm::packUnorm2x16(texCoordMin);
+			glyph.TexCoords[1] = glm::packUnorm2x16({ texCoordMin.x, texCoordMax.y });
+			glyph.TexCoords[2] = glm::packUnorm2x16(texCoordMax);
+			glyph.TexCoords[3] = glm::packUnorm2x16({ texCoordMax.x, texCoordMin.y });
+			glyph.Page = fontGlyph.Page;
+
+			layout->BoundsMin = glm::min(layout->BoundsMin, quadMin);
+			layout->BoundsMax = glm::max(layout->BoundsMax, quadMax);
+		});
+
+		std::unique_lock<std::shared_mutex> lock(s_Data.TextLayoutMutex);
+
+		// Another thread may have laid out the same string in the meantime
+		auto [begin, end] = s_Data.TextLayouts.equal_range(hash);
+		for (auto it = begin; it != end; ++it)
+		{
+			if (it->second->Matches(string, font, textParams.Kerning, textParams.LineSpacing))
+				return *it->second;
+		}
+
+		return *s_Data.TextLayouts.emplace(hash, std::move(layout))->second;
+	}
+
+	void Renderer2D::DrawString(const std::string& string, Ref<Font> font, const glm::mat4& transform, const TextParams& textParams, int entityID)
+	{
+		const TextLayout& layout = GetTextLayout(string, font, textParams);
+		if (layout.Glyphs.empty())
+			return;
+
+		RecordingContext& context = GetRecordingContext();
+		uint32_t page = 0;
+		uint32_t fontAtlasIndex = GetContextTextureIndex(context, font->GetAtlasTexture(page));
+		uint32_t color = PackColor(textParams.Color);
+
+		glm::vec3 origin = transform[3];
+		glm::vec3 axisX = transform[0];
+		glm::vec3 axisY = transform[1];
+
+		for (const TextLayout::Glyph& glyph : layout.Glyphs)
+		{
+			if (glyph.Page != page)
+			{
+				page = glyph.Page;
+				fontAtlasIndex = GetContextTextureIndex(context, font->GetAtlasTexture(page));
+			}
+
+			if (s_Data.Specification.UnifiedPipeline)
+			{
+				QuadPayload& glyphQuad = context.QuadPayloads.emplace_back();
+				QuadInstance& instance = glyphQuad.Instance;
+				glm::vec2 center = (glyph.QuadMin + glyph.QuadMax) * 0.5f;
+				instance.Position = origin + center.x * axisX + center.y * axisY;
+				instance.AxisX = (glyph.QuadMax.x - glyph.QuadMin.x) * axisX;
+				instance.AxisY = (glyph.QuadMax.y - glyph.QuadMin.y) * axisY;
+				instance.Color = color;
+				instance.TexRect[0] = (uint16_t)(glyph.TexCoords[0] & 0xFFFF);
+				instance.TexRect[1] = (uint16_t)(glyph.TexCoords[0] >> 16);
+				instance.TexRect[2] = (uint16_t)(glyph.TexCoords[2] & 0xFFFF);
+				instance.TexRect[3] = (uint16_t)(glyph.TexCoords[2] >> 16);
+				instance.TilingFactor = glm::packHalf1x16(1.0f);
+				instance.TexIndex = 0;
+				instance.Flags = QuadInstanceText;
+				instance.EntityID = entityID;
+				glyphQuad.Texture = fontAtlasIndex;
+
+				Submit(context, PrimitiveType::Quad, origin, fontAtlasIndex, entityID, (uint32_t)context.QuadPayloads.size() - 1);
+				continue;
+			}
+
+			glm::vec3 left = origin + glyph.QuadMin.x * axisX;
+			glm::vec3 right = origin + glyph.QuadMax.x * axisX;
+			glm::vec3 bottom = glyph.QuadMin.y * axisY;
+			glm::vec3 top = glyph.QuadMax.y * axisY;
+
+			GlyphPayload& glyphQuad = context.GlyphPayloads.emplace_back();
+			glyphQuad.Vertices[0] = { left + bottom, color, glyph.TexCoords[0], 0, {}, entityID };
+			glyphQuad.Vertices[1] = { left + top, color, glyph.TexCoords[1], 0, {}, entityID };
+			glyphQuad.Vertices[2] = { right + top, color, glyph.TexCoords[2], 0, {}, entityID };
+			glyphQuad.Vertices[3] = { right + bottom, color, glyph.TexCoords[3], 0, {}, entityID };
+			glyphQuad.FontAtlas = fontAtlasIndex;
+
+			// Glyphs sort by the string origin so a string stays together
+			Submit(context, PrimitiveType::Text, origin, fontAtlasIndex, entityID, (uint32_t)context.GlyphPayloads.size() - 1);
+		}
+
+		context.QuadCount += (uint32_t)layout.Glyphs.size();
 	}
 
 	void Renderer2D::DrawString(const std::string& string, const glm::mat4& transform, const TextComponent& component, int entityID)
@@ -646,6 +1400,15 @@ namespace Cobra {
 		DrawString(string, component.FontAsset, transform, { component.Color, component.Kerning, component.LineSpacing }, entityID);
 	}
 
+	bool Renderer2D::GetStringBounds(const std::string& string, Ref<Font> font, const TextParams& textParams, glm::vec2& outMin, glm::vec2& outMax)
+	{
+		const TextLayout& layout = GetTextLayout(string, font, textParams);
+		outMin = layout.BoundsMin;
+		outMax = layout.BoundsMax;
+
+		return !layout.Glyphs.empty();
+	}
+
 	float Cobra::Renderer2D::GetLineWidth()
 	{
 		return s_Data.LineWidth;
@@ -658,35 +1421,140 @@ namespace Cobra {
 
 	void Renderer2D::ResetStats()
 	{
-		memset(&s_Data.Stats, 0, sizeof(Statistics));
+		RenderThread::Submit([]()
+		{
+			std::scoped_lock<std::mutex> lock(s_Data.StatsMutex);
+			s_Data.PublishedStats = s_Data.Stats;
+			memset(&s_Data.Stats, 0, sizeof(Statistics));
+		});
 	}
 
 	Renderer2D::Statistics Renderer2D::GetStats()
 	{
-		return s_Data.Stats;
+		if (!RenderThread::IsRunning())
+			return s_Data.Stats;
+
+		std::scoped_lock<std::mutex> lock(s_Data.StatsMutex);
+		return s_Data.PublishedStats;
+	}
+
+	void Renderer2D::AddCulledCount(uint32_t count)
+	{
+		RenderThread::Submit([count]() { s_Data.Stats.CulledCount += count; });
 	}
 
-	void Renderer2D::StartBatch()
+	const Frustum& Renderer2D::GetFrustum()
 	{
-		s_Data.QuadIndexCount = 0;
-		s_Data.QuadVertexBufferPtr = s_Data.QuadVertexBufferBase;
+		return s_Data.ViewFrustum;
+	}
 
-		s_Data.CircleIndexCount = 0;
-		s_Data.CircleVertexBufferPtr = s_Data.CircleVertexBufferBase;
+	const RendererSpecification& Renderer2D::GetSpecification()
+	{
+		return s_Data.Specification;
+	}
 
-		s_Data.LineVertexCount = 0;
-		s_Data.LineVertexBufferPtr = s_Data.LineVertexBufferBase;
+	void Renderer2D::RecordParallel(uint32_t count, const std::function<void(uint32_t begin, uint32_t end)>& func)
+	{
+		CB_PROFILE_FUNCTION();
+		CB_CORE_ASSERT(!t_RecordingContext, "Renderer2D::RecordParallel can not be nested!");
 
-		s_Data.TextIndexCount = 0;
-		s_Data.TextVertexBufferPtr = s_Data.TextVertexBufferBase;
+		ThreadPool& threadPool = Application::Get().GetThreadPool();
+		uint32_t sliceCount = std::min(threadPool.GetThreadCount() + 1, (count + s_Data.MinRecordSliceSize - 1) / s_Data.MinRecordSliceSize);
 
-		s_Data.TextureSlotIndex = 1;
+		SceneRecording& recording = *s_Data.Recording;
+		if (sliceCount <= 1 || recording.ContextCount + sliceCount > s_Data.MaxRecordingContexts)
+		{
+			func(0, count);
+			return;
+		}
+
+		uint32_t firstContext = recording.ContextCount;
+		recording.ContextCount += sliceCount;
+
+		while (recording.Contexts.size() < recording.ContextCount)
+		{
+			Scope<RecordingContext>& context = recording.Contexts.emplace_back(CreateScope<RecordingContext>());
+			context->Index = (uint32_t)recording.Contexts.size() - 1;
+			context->Reset(s_Data.WhiteTexture);
+		}
+
+		threadPool.ParallelFor(sliceCount, [&](uint32_t slice)
+		{
+			uint32_t begin = (uint32_t)((uint64_t)count * slice / sliceCount);
+			uint32_t end = (uint32_t)((uint64_t)count * (slice + 1) / sliceCount);
+
+			t_RecordingContext = recording.Contexts[firstContext + slice].get();
+			func(begin, end);
+			t_RecordingContext = nullptr;
+		});
 	}
 
-	void Renderer2D::NextBatch()
+	void Cobra::Renderer2D::SetLayer(uint8_t layer)
 	{
-		Flush();
-		StartBatch();
+		s_Data.Layer = layer;
+	}
+
+	uint8_t Cobra::Renderer2D::GetLayer()
+	{
+		return s_Data.Layer;
+	}
+
+	StaticQuadBatch::StaticQuadBatch(const Ref<Texture2D>& texture, uint32_t capacity)
+		: m_Texture(texture), m_Capacity(capacity)
+	{
+		CB_PROFILE_FUNCTION();
+
+		m_InstanceBuffer = VertexBuffer::Create(capacity * s_Data.QuadStream.Stride);
+		m_InstanceBuffer->SetLayout(s_Data.QuadStream.Layout); // The stream's buffer is replaced on the render thread when it grows
+
+		m_VertexArray = VertexArray::Create();
+		m_VertexArray->AddVertexBuffer(s_Data.UnitQuadVertexBuffer);
+		m_VertexArray->AddVertexBuffer(m_InstanceBuffer, VertexInputRate::PerInstance);
+		m_VertexArray->SetIndexBuffer(s_Data.UnitQuadIndexBuffer);
+
+		m_Instances.reserve((size_t)capacity * s_Data.QuadStream.Stride);
+	}
+
+	void StaticQuadBatch::Begin()
+	{
+		m_Instances.clear();
+		m_Count = 0;
+
+		m_BoundsMin = glm::vec3(std::numeric_limits<float>::max());
+		m_BoundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+	}
+
+	void StaticQuadBatch::AddQuad(const glm::mat4& transform, const glm::vec4& color, float tilingFactor, int entityID)
+	{
+		CB_CORE_ASSERT(m_Count < m_Capacity, "StaticQuadBatch is full!");
+
+		QuadInstance instance;
+		FillQuadInstance(instance, transform, color, tilingFactor, entityID);
+		instance.TexIndex = m_Texture ? 1 : 0;
+
+		const uint8_t* data = (const uint8_t*)&instance;
+		m_Instances.insert(m_Instances.end(), data, data + s_Data.QuadStream.Stride);
+		m_Count++;
+
+		glm::vec3 extent = glm::abs(instance.AxisX) * 0.5f + glm::abs(instance.AxisY) * 0.5f;
+		m_BoundsMin = glm::min(m_BoundsMin, instance.Position - extent);
+		m_BoundsMax = glm::max(m_BoundsMax, instance.Position + extent);
+	}
+
+	void StaticQuadBatch::End()
+	{
+		CB_PROFILE_FUNCTION();
+
+		if (m_Count)
+			m_InstanceBuffer->SetData(m_Instances.data(), (uint32_t)m_Instances.size());
+	}
+
+	void Renderer2D::StartBatch()
+	{
+		SceneRecording& recording = *s_Data.Recording;
+		for (uint32_t i = 0; i < recording.ContextCount; i++)
+			recording.Contexts[i]->Reset(s_Data.WhiteTexture);
+		recording.ContextCount = 1;
 	}
 
-}
\ No newline at end of file
+}
@@ -1,18 +1,56 @@
 #pragma once
 
+#include "Cobra/Renderer/Renderer.h"
 #include "Cobra/Renderer/OrthographicCamera.h"
 #include "Cobra/Renderer/EditorCamera.h"
 #include "Cobra/Renderer/Camera.h"
 #include "Cobra/Renderer/Texture.h"
 #include "Cobra/Renderer/Font.h"
+#include "Cobra/Renderer/VertexArray.h"
+#include "Cobra/Renderer/Frustum.h"
 #include "Cobra/Scene/Components.h"
 
 namespace Cobra {
 
+	// Quads sharing one texture, baked into a persistent GPU buffer and redrawn with a
+	// single instanced call every frame until they are rebuilt
+	class StaticQuadBatch
+	{
+	private:
+		Ref<Texture2D> m_Texture;
+		Ref<VertexBuffer> m_InstanceBuffer;
+		Ref<VertexArray> m_VertexArray;
+
+		std::vector<uint8_t> m_Instances;
+		uint32_t m_Capacity = 0;
+		uint32_t m_Count = 0;
+
+		glm::vec3 m_BoundsMin = glm::vec3(0.0f);
+		glm::vec3 m_BoundsMax = glm::vec3(0.0f);
+	public:
+		// A null texture draws with the white texture
+		StaticQuadBatch(const Ref<Texture2D>& texture, uint32_t capacity);
+
+		// Rebuilds the batch, quads are only uploaded at End
+		void Begin();
+		void AddQuad(const glm::mat4& transform, const glm::vec4& color, float tilingFactor = 1.0f, int entityID = -1);
+		void End();
+
+		void SetTexture(const Ref<Texture2D>& texture) { m_Texture = texture; }
+		const Ref<Texture2D>& GetTexture() const { return m_Texture; }
+		const Ref<VertexArray>& GetVertexArray() const { return m_VertexArray; }
+
+		uint32_t GetCount() const { return m_Count; }
+		uint32_t GetCapacity() const { return m_Capacity; }
+
+		const glm::vec3& GetBoundsMin() const { return m_BoundsMin; }
+		const glm::vec3& GetBoundsMax() const { return m_BoundsMax; }
+	};
+
 	class Renderer2D
 	{
 	public:
-		static void Init();
+		static void Init(const RendererSpecification& specification = RendererSpecification());
 		static void Shutdown();
 
 		static void BeginScene(const Camera& camera, const glm::mat4& transform);
@@ -37,11 +75,14 @@ namespace Cobra {
 
 		static void DrawCircle(const glm::mat4& transform, const glm::vec4& color, float thickness = 1.0f, float fade = 0.005f, int entityID = -1);
 		static void DrawLine(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color, int entityID = -1);
+		// Width is in pixels, the other overloads use the line width
+		static void DrawLine(const glm::vec3& p0, const glm::vec3& p1, const glm::vec4& color, float width, int entityID = -1);
 
 		static void DrawRect(const glm::vec3& position, const glm::vec2& size, const glm::vec4& color, int entityID = -1);
 		static void DrawRect(const glm::mat4& transform, const glm::vec4& color, int entityID = -1);
 
 		static void DrawSprite(const glm::mat4& transform, SpriteRendererComponent& src, int entityID);
+		static void DrawStaticBatch(const Ref<StaticQuadBatch>& batch);
 
 		struct TextParams
 		{
@@ -52,14 +93,30 @@ namespace Cobra {
 		static void DrawString(const std::string& string, Ref<Font> font, const glm::mat4& transform, const TextParams& textParams, int entityID = -1);
 		static void DrawString(const std::string& string, const glm::mat4& transform, const TextComponent& component, int entityID = -1);
 
+		// Bounds of the string's glyph quads before the transform is applied, false if it has none
+		static bool GetStringBounds(const std::string& string, Ref<Font> font, const TextParams& textParams, glm::vec2& outMin, glm::vec2& outMax);
+
+		// Calls func for slices of [0, count) on the application's thread pool. Every slice records
+		// into its own thread local context, which are merged into the scene at EndScene.
+		// Draws issued from func must not cause assets to be loaded.
+		static void RecordParallel(uint32_t count, const std::function<void(uint32_t begin, uint32_t end)>& func);
+
 		static float GetLineWidth();
 		static void SetLineWidth(float width);
 
+		// Primitives on a higher layer are drawn on top regardless of depth
+		static uint8_t GetLayer();
+		static void SetLayer(uint8_t layer);
+
+		// Frustum of the current scene's camera, for culling before anything is submitted
+		static const Frustum& GetFrustum();
+
 		// Stats
 		struct Statistics
 		{
 			uint32_t DrawCalls = 0;
 			uint32_t QuadCount = 0;
+			uint32_t CulledCount = 0; // Renderables skipped by frustum culling
 
 			uint32_t GetTotalVertexCount() const { return QuadCount * 4; }
 			uint32_t GetTotalIndexCount() const { return QuadCount * 6; }
@@ -67,9 +124,11 @@ namespace Cobra {
 
 		static void ResetStats();
 		static Statistics GetStats();
+		static void AddCulledCount(uint32_t count);
+
+		static const RendererSpecification& GetSpecification();
 	private:
 		static void StartBatch();
-		static void NextBatch();
 	};
 
 }
\ No newline at end of file
@@ -1,8 +1,23 @@
 #include "cbpch.h"
 #include "RendererAPI.h"
 
+#include "Platform/Null/NullRendererAPI.h"
+#include "Platform/OpenGL/OpenGLRendererAPI.h"
+
 namespace Cobra {
 
 	RendererAPI::API RendererAPI::s_API = RendererAPI::API::OpenGL;
 
+	Scope<RendererAPI> RendererAPI::Create()
+	{
+		switch (s_API)
+		{
+			case RendererAPI::API::None:     return CreateScope<NullRendererAPI>();
+			case RendererAPI::API::OpenGL:   return CreateScope<OpenGLRendererAPI>();
+		}
+
+		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return nullptr;
+	}
+
 }
\ No newline at end of file
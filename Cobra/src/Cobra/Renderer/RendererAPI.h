@@ -14,6 +14,12 @@ namespace Cobra {
 			None = 0,
 			OpenGL = 1
 		};
+
+		struct StateStatistics
+		{
+			uint32_t Issued = 0;
+			uint32_t Elided = 0; // Redundant changes that never reached the driver
+		};
 	private:
 		static API s_API;
 	public:
@@ -21,15 +27,21 @@ namespace Cobra {
 
 		virtual void Init() = 0;
 		virtual void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+		virtual void GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) const = 0;
 		virtual void SetClearColor(const glm::vec4& color) = 0;
 		virtual void Clear() const = 0;
 
-		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) = 0;
-		virtual void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) = 0;
+		virtual void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t vertexOffset = 0) = 0;
+		virtual void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t instanceOffset = 0) = 0;
 
-		virtual void SetLineWidth(float width) = 0;
+		virtual StateStatistics GetStateStatistics() const = 0;
+		virtual void ResetStateStatistics() = 0;
 
 		inline static API GetAPI() { return s_API; }
+		// Must be called before the renderer is initialized
+		inline static void SetAPI(API api) { s_API = api; }
+
+		static Scope<RendererAPI> Create();
 	};
 
 }
\ No newline at end of file
@@ -2,16 +2,18 @@
 #include "Shader.h"
 
 #include "Cobra/Renderer/Renderer.h"
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/Null/NullShader.h"
 #include "Platform/OpenGL/OpenGLShader.h"
 
 namespace Cobra {
 
-	Ref<Shader> Shader::Create(const std::string& filepath)
+	Ref<Shader> Shader::Create(const std::string& filepath, const std::vector<std::string>& defines)
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:     CB_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
-			case RendererAPI::API::OpenGL:   return CreateRef<OpenGLShader>(filepath);
+			case RendererAPI::API::None:     return CreateRef<NullShader>(filepath, defines);
+			case RendererAPI::API::OpenGL:   return RenderThread::CreateResource<OpenGLShader>(filepath, defines);
 		}
 
 		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
@@ -22,14 +24,33 @@ namespace Cobra {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:     CB_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
-			case RendererAPI::API::OpenGL:   return CreateRef<OpenGLShader>(name, vertexSource, fragmentSource);
+			case RendererAPI::API::None:     return CreateRef<NullShader>(name, vertexSource, fragmentSource);
+			case RendererAPI::API::OpenGL:   return RenderThread::CreateResource<OpenGLShader>(name, vertexSource, fragmentSource);
 		}
 
 		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
 		return nullptr;
 	}
 
+	std::vector<Ref<Shader>> Shader::Create(const std::vector<ShaderVariant>& variants)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:
+			{
+				std::vector<Ref<Shader>> shaders;
+				for (const ShaderVariant& variant : variants)
+					shaders.push_back(CreateRef<NullShader>(variant.Filepath, variant.Defines));
+
+				return shaders;
+			}
+			case RendererAPI::API::OpenGL:   return OpenGLShader::CreateParallel(variants);
+		}
+
+		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
+		return {};
+	}
+
 	void ShaderLibrary::Add(const std::string& name, const Ref<Shader>& shader)
 	{
 		CB_CORE_ASSERT(!Exists(name), "Shader already exists!");
@@ -2,10 +2,55 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace Cobra {
 
+	enum class ShaderUniformType
+	{
+		None = 0, Int, Float, Float2, Float3, Float4, Mat3, Mat4, Sampler
+	};
+
+	// Resolved once through GetUniform, setting through it skips the name lookup entirely
+	struct ShaderUniformHandle
+	{
+		int32_t Location = -1;
+		ShaderUniformType Type = ShaderUniformType::None;
+		uint32_t Count = 0; // Array size, 1 for plain uniforms
+
+		bool IsValid() const { return Location != -1; }
+	};
+
+	struct ShaderUniformBufferInfo
+	{
+		std::string Name;
+		uint32_t Binding = 0;
+		uint32_t Size = 0;
+		uint32_t MemberCount = 0;
+	};
+
+	struct ShaderSamplerInfo
+	{
+		std::string Name;
+		uint32_t Binding = 0;
+		uint32_t Count = 1;
+	};
+
+	// Gathered once when the program is created
+	struct ShaderReflection
+	{
+		std::unordered_map<std::string, ShaderUniformHandle> Uniforms; // Uniforms outside of blocks, arrays without the [0] suffix
+		std::vector<ShaderUniformBufferInfo> UniformBuffers;
+		std::vector<ShaderSamplerInfo> Samplers;
+	};
+
+	struct ShaderVariant
+	{
+		std::string Filepath;
+		std::vector<std::string> Defines;
+	};
+
 	class Shader
 	{
 	public:
@@ -22,10 +67,25 @@ namespace Cobra {
 		virtual void SetFloat4(const std::string& name, const glm::vec4& value) = 0;
 		virtual void SetMat4(const std::string& name, const glm::mat4& value) = 0;
 
+		// Returns an invalid handle if the program has no such uniform, setting through it is then a no-op
+		virtual ShaderUniformHandle GetUniform(const std::string& name) const = 0;
+
+		virtual void SetInt(ShaderUniformHandle uniform, int value) = 0;
+		virtual void SetIntArray(ShaderUniformHandle uniform, int* values, uint32_t count) = 0;
+		virtual void SetFloat(ShaderUniformHandle uniform, float value) = 0;
+		virtual void SetFloat2(ShaderUniformHandle uniform, const glm::vec2& value) = 0;
+		virtual void SetFloat3(ShaderUniformHandle uniform, const glm::vec3& value) = 0;
+		virtual void SetFloat4(ShaderUniformHandle uniform, const glm::vec4& value) = 0;
+		virtual void SetMat4(ShaderUniformHandle uniform, const glm::mat4& value) = 0;
+
+		virtual const ShaderReflection& GetReflection() const = 0;
 		virtual const std::string& GetName() const = 0;
 
-		static Ref<Shader> Create(const std::string& filepath);
+		// Defines are passed to the compiler as macros, so one file can produce several variants
+		static Ref<Shader> Create(const std::string& filepath, const std::vector<std::string>& defines = {});
 		static Ref<Shader> Create(const std::string& name, const std::string& vertexSource, const std::string& fragmentSource);
+		// Compiles the variants concurrently, the shaders are returned in the same order
+		static std::vector<Ref<Shader>> Create(const std::vector<ShaderVariant>& variants);
 	};
 
 	class ShaderLibrary
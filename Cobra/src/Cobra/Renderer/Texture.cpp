@@ -2,6 +2,8 @@
 #include "Texture.h"
 
 #include "Renderer.h"
+#include "RenderThread.h"
+#include "Platform/Null/NullTexture.h"
 #include "Platform/OpenGL/OpenGLTexture.h"
 
 namespace Cobra {
@@ -10,12 +12,23 @@ namespace Cobra {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:     CB_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
-			case RendererAPI::API::OpenGL:   return CreateRef<OpenGLTexture2D>(specification, data);
+			case RendererAPI::API::None:     return CreateRef<NullTexture2D>(specification, data);
+			case RendererAPI::API::OpenGL:   return RenderThread::CreateResource<OpenGLTexture2D>(specification, data);
 		}
 
 		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
 		return nullptr;
 	}
 
+	void Texture2D::UpdateAsyncUploads(uint64_t budget)
+	{
+		switch (Renderer::GetAPI())
+		{
+			case RendererAPI::API::None:     return; // Null textures upload immediately
+			case RendererAPI::API::OpenGL:   OpenGLTexture2D::UpdateAsyncUploads(budget); return;
+		}
+
+		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
+	}
+
 }
\ No newline at end of file
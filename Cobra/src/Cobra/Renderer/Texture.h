@@ -15,7 +15,12 @@ namespace Cobra {
 		R8,
 		RGB8,
 		RGBA8,
-		RGBA32F
+		RGBA32F,
+
+		// Block compressed, see TextureCompressor
+		BC1,
+		BC3,
+		BC7
 	};
 
 	struct TextureSpecification
@@ -38,6 +43,17 @@ namespace Cobra {
 		virtual uint32_t GetRendererID() const = 0;
 
 		virtual void SetData(Buffer data) = 0;
+		// Copies the data into a staging buffer that is uploaded over the next frames, within the
+		// renderer's upload budget. The texture is not loaded until the GPU has finished the copy.
+		virtual void SetDataAsync(Buffer data) = 0;
+		// Uploads a tightly packed width x height block with its bottom left corner at (x, y)
+		virtual void SetData(Buffer data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) = 0;
+		// Zeroes every level on the GPU without uploading anything, only for uncompressed formats
+		virtual void Clear() = 0;
+		// Copies a width x height block of level 0 of source on the GPU, both textures must have the same format.
+		// Lower levels are left as they are until RegenerateMips is called.
+		virtual void CopyFrom(const Texture& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height, uint32_t x, uint32_t y) = 0;
+		virtual void RegenerateMips() = 0;
 
 		virtual void Bind(uint32_t slot = 0) const = 0;
 
@@ -51,6 +67,9 @@ namespace Cobra {
 	public:
 		static Ref<Texture2D> Create(const TextureSpecification& specification, Buffer data = Buffer());
 
+		// Issues pending asynchronous uploads up to budget bytes and completes finished ones
+		static void UpdateAsyncUploads(uint64_t budget);
+
 		static AssetType GetStaticType() { return AssetType::Texture2D; }
 		AssetType GetType() const override { return GetStaticType(); }
 	};
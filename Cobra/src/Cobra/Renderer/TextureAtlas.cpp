@@ -0,0 +1,137 @@
+#include "cbpch.h"
+#include "TextureAtlas.h"
+
+#include "Cobra/Renderer/TextureCompressor.h"
+
+namespace Cobra {
+
+	TextureAtlas::TextureAtlas(uint32_t pageSize, uint32_t maxTextureSize)
+		: m_PageSize(pageSize), m_MaxTextureSize(std::min(maxTextureSize, pageSize - 2))
+	{ }
+
+	bool TextureAtlas::GetRegion(const Ref<Texture2D>& texture, TextureAtlasRegion& outRegion)
+	{
+		if (texture->GetWidth() > m_MaxTextureSize || texture->GetHeight() > m_MaxTextureSize || !texture->IsLoaded()
+			|| TextureCompressor::IsCompressed(texture->GetSpecification().Format))
+			return false;
+
+		{
+			std::shared_lock<std::shared_mutex> lock(m_Mutex);
+
+			auto it = m_Entries.find(texture->GetRendererID());
+			if (it != m_Entries.end() && it->second.Source.lock() == texture)
+			{
+				outRegion = it->second.Region;
+				return true;
+			}
+		}
+
+		std::unique_lock<std::shared_mutex> lock(m_Mutex);
+		if (std::find(m_Requests.begin(), m_Requests.end(), texture) == m_Requests.end())
+			m_Requests.push_back(texture);
+
+		return false;
+	}
+
+	void TextureAtlas::Update()
+	{
+		std::unique_lock<std::shared_mutex> lock(m_Mutex);
+		if (m_Requests.empty())
+			return;
+
+		CB_PROFILE_FUNCTION();
+
+		// Space of destroyed textures is not reclaimed, only their entries
+		for (auto it = m_Entries.begin(); it != m_Entries.end();)
+		{
+			if (it->second.Source.expired())
+				it = m_Entries.erase(it);
+			else
+				++it;
+		}
+
+		// Tallest first packs the shelves tighter
+		std::sort(m_Requests.begin(), m_Requests.end(), [](const Ref<Texture2D>& a, const Ref<Texture2D>& b) { return a->GetHeight() > b->GetHeight(); });
+
+		for (const Ref<Texture2D>& texture : m_Requests)
+			Pack(texture);
+
+		m_Requests.clear();
+
+		for (Page& page : m_Pages)
+		{
+			if (page.Dirty)
+			{
+				page.Texture->RegenerateMips();
+				page.Dirty = false;
+			}
+		}
+	}
+
+	void TextureAtlas::Pack(const Ref<Texture2D>& texture)
+	{
+		ImageFormat format = texture->GetSpecification().Format;
+		bool mips = texture->GetSpecification().GenerateMips;
+		uint32_t width = texture->GetWidth();
+		uint32_t height = texture->GetHeight();
+		uint32_t slotWidth = width + 2;
+		uint32_t slotHeight = height + 2;
+
+		// Shelf packing into the last page matching the texture, starting a new shelf or page when it is full
+		Page* page = nullptr;
+		for (size_t i = m_Pages.size(); i-- > 0;)
+		{
+			const TextureSpecification& pageSpec = m_Pages[i].Texture->GetSpecification();
+			if (pageSpec.Format == format && pageSpec.GenerateMips == mips)
+			{
+				page = &m_Pages[i];
+				break;
+			}
+		}
+
+		if (page && page->CursorX + slotWidth > m_PageSize)
+		{
+			page->ShelfY += page->ShelfHeight;
+			page->ShelfHeight = 0;
+			page->CursorX = 0;
+		}
+
+		if (!page || page->ShelfY + slotHeight > m_PageSize)
+		{
+			TextureSpecification spec;
+			spec.Width = m_PageSize;
+			spec.Height = m_PageSize;
+			spec.Format = format;
+			spec.GenerateMips = mips;
+
+			page = &m_Pages.emplace_back();
+			page->Texture = Texture2D::Create(spec);
+		}
+
+		uint32_t x = page->CursorX + 1;
+		uint32_t y = page->ShelfY + 1;
+		page->CursorX += slotWidth;
+		page->ShelfHeight = std::max(page->ShelfHeight, slotHeight);
+		page->Dirty = mips;
+
+		Texture2D& atlas = *page->Texture;
+		atlas.CopyFrom(*texture, 0, 0, width, height, x, y);
+
+		// Border, edges then corners
+		atlas.CopyFrom(*texture, 0, 0, 1, height, x - 1, y);
+		atlas.CopyFrom(*texture, width - 1, 0, 1, height, x + width, y);
+		atlas.CopyFrom(*texture, 0, 0, width, 1, x, y - 1);
+		atlas.CopyFrom(*texture, 0, height - 1, width, 1, x, y + height);
+		atlas.CopyFrom(*texture, 0, 0, 1, 1, x - 1, y - 1);
+		atlas.CopyFrom(*texture, width - 1, 0, 1, 1, x + width, y - 1);
+		atlas.CopyFrom(*texture, 0, height - 1, 1, 1, x - 1, y + height);
+		atlas.CopyFrom(*texture, width - 1, height - 1, 1, 1, x + width, y + height);
+
+		Entry& entry = m_Entries[texture->GetRendererID()];
+		entry.Source = texture;
+		entry.Region.Page = page->Texture;
+		entry.Region.UVMin = glm::vec2((float)x, (float)y) / (float)m_PageSize;
+		entry.Region.UVMax = glm::vec2((float)(x + width), (float)(y + height)) / (float)m_PageSize;
+	}
+
+}
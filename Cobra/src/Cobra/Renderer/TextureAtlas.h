@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Cobra/Renderer/Texture.h"
+
+#include <glm/glm.hpp>
+
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace Cobra {
+
+	struct TextureAtlasRegion
+	{
+		Ref<Texture2D> Page;
+		glm::vec2 UVMin = glm::vec2(0.0f);
+		glm::vec2 UVMax = glm::vec2(1.0f);
+	};
+
+	// Packs small textures into shared pages, so quads using different textures can still be
+	// drawn in one batch. Textures are copied on the GPU surrounded by a 1 pixel border of their
+	// edge texels, which keeps linear filtering from bleeding in their neighbours. Pages have mips
+	// if the textures on them do, which are regenerated from level 0 and bleed a little further
+	// out. Block compressed textures can not be copied texel by texel and are never packed.
+	class TextureAtlas
+	{
+	private:
+		struct Page
+		{
+			Ref<Texture2D> Texture;
+			uint32_t ShelfY = 0, ShelfHeight = 0, CursorX = 0;
+			bool Dirty = false; // Mips are out of date
+		};
+
+		struct Entry
+		{
+			std::weak_ptr<Texture2D> Source; // Renderer IDs are reused once a texture is destroyed
+			TextureAtlasRegion Region;
+		};
+
+		uint32_t m_PageSize;
+		uint32_t m_MaxTextureSize;
+
+		std::vector<Page> m_Pages;
+		std::unordered_map<uint32_t, Entry> m_Entries; // Source renderer ID -> entry
+
+		std::vector<Ref<Texture2D>> m_Requests;
+		std::shared_mutex m_Mutex;
+	public:
+		TextureAtlas(uint32_t pageSize, uint32_t maxTextureSize);
+
+		// Returns false while the texture is not packed, and queues it if it is small enough. Thread safe.
+		bool GetRegion(const Ref<Texture2D>& texture, TextureAtlasRegion& outRegion);
+		// Packs the queued textures. Must not be called while recording.
+		void Update();
+
+		uint32_t GetPageCount() const { return (uint32_t)m_Pages.size(); }
+	private:
+		void Pack(const Ref<Texture2D>& texture);
+	};
+
+}
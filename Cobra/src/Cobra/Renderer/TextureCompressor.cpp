@@ -0,0 +1,394 @@
+#include "cbpch.h"
+#include "TextureCompressor.h"
+
+#include "Cobra/Core/Application.h"
+
+namespace Cobra {
+
+	namespace Utils {
+
+		// Box filters to half size, odd edges repeat their last texel
+		static void DownsampleRGBA(const std::vector<uint8_t>& source, uint32_t width, uint32_t height, std::vector<uint8_t>& destination)
+		{
+			uint32_t destinationWidth = std::max(width / 2, 1u);
+			uint32_t destinationHeight = std::max(height / 2, 1u);
+			destination.resize((size_t)destinationWidth * destinationHeight * 4);
+
+			for (uint32_t y = 0; y < destinationHeight; y++)
+			{
+				uint32_t y0 = std::min(y * 2, height - 1);
+				uint32_t y1 = std::min(y * 2 + 1, height - 1);
+
+				for (uint32_t x = 0; x < destinationWidth; x++)
+				{
+					uint32_t x0 = std::min(x * 2, width - 1);
+					uint32_t x1 = std::min(x * 2 + 1, width - 1);
+
+					for (uint32_t c = 0; c < 4; c++)
+					{
+						uint32_t sum = source[((size_t)y0 * width + x0) * 4 + c] + source[((size_t)y0 * width + x1) * 4 + c]
+							+ source[((size_t)y1 * width + x0) * 4 + c] + source[((size_t)y1 * width + x1) * 4 + c];
+						destination[((size_t)y * destinationWidth + x) * 4 + c] = (uint8_t)((sum + 2) / 4);
+					}
+				}
+			}
+		}
+
+	}
+
+	using Block = uint8_t[16][4];
+
+	static void LoadBlock(const uint8_t* rgba, uint32_t width, uint32_t height, uint32_t blockX, uint32_t blockY, Block& block)
+	{
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			uint32_t x = std::min(blockX * 4 + i % 4, width - 1);
+			uint32_t y = std::min(blockY * 4 + i / 4, height - 1);
+			memcpy(block[i], rgba + ((size_t)y * width + x) * 4, 4);
+		}
+	}
+
+	// Ends of the block's principal axis over the first channelCount channels
+	static void FindEndpoints(const Block& block, uint32_t channelCount, float outMin[4], float outMax[4])
+	{
+		float mean[4] = {};
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t c = 0; c < channelCount; c++)
+				mean[c] += block[i][c] / 16.0f;
+		}
+
+		float covariance[4][4] = {};
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t a = 0; a < channelCount; a++)
+			{
+				for (uint32_t b = 0; b < channelCount; b++)
+					covariance[a][b] += (block[i][a] - mean[a]) * (block[i][b] - mean[b]);
+			}
+		}
+
+		// Power iteration
+		float axis[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+		for (uint32_t iteration = 0; iteration < 8; iteration++)
+		{
+			float next[4] = {};
+			float length = 0.0f;
+			for (uint32_t a = 0; a < channelCount; a++)
+			{
+				for (uint32_t b = 0; b < channelCount; b++)
+					next[a] += covariance[a][b] * axis[b];
+				length = std::max(length, std::abs(next[a]));
+			}
+
+			if (length < 1e-6f)
+				break;
+
+			for (uint32_t c = 0; c < channelCount; c++)
+				axis[c] = next[c] / length;
+		}
+
+		float minT = std::numeric_limits<float>::max();
+		float maxT = std::numeric_limits<float>::lowest();
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			float t = 0.0f;
+			for (uint32_t c = 0; c < channelCount; c++)
+				t += (block[i][c] - mean[c]) * axis[c];
+
+			minT = std::min(minT, t);
+			maxT = std::max(maxT, t);
+		}
+
+		float axisLengthSquared = 0.0f;
+		for (uint32_t c = 0; c < channelCount; c++)
+			axisLengthSquared += axis[c] * axis[c];
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			float scale = c < channelCount ? axis[c] / axisLengthSquared : 0.0f;
+			outMin[c] = std::clamp(mean[c] + scale * minT, 0.0f, 255.0f);
+			outMax[c] = std::clamp(mean[c] + scale * maxT, 0.0f, 255.0f);
+		}
+	}
+
+	template<uint32_t N>
+	static uint32_t FindClosest(const uint8_t texel[4], const int palette[][4], uint32_t paletteSize)
+	{
+		uint32_t best = 0;
+		int bestError = std::numeric_limits<int>::max();
+		for (uint32_t i = 0; i < paletteSize; i++)
+		{
+			int error = 0;
+			for (uint32_t c = 0; c < N; c++)
+				error += (texel[c] - palette[i][c]) * (texel[c] - palette[i][c]);
+
+			if (error < bestError)
+			{
+				best = i;
+				bestError = error;
+			}
+		}
+
+		return best;
+	}
+
+	static uint16_t PackRGB565(const float color[4])
+	{
+		uint16_t r = (uint16_t)std::round(color[0] * 31.0f / 255.0f);
+		uint16_t g = (uint16_t)std::round(color[1] * 63.0f / 255.0f);
+		uint16_t b = (uint16_t)std::round(color[2] * 31.0f / 255.0f);
+		return (r << 11) | (g << 5) | b;
+	}
+
+	static void UnpackRGB565(uint16_t color, int out[4])
+	{
+		int r = color >> 11, g = (color >> 5) & 0x3F, b = color & 0x1F;
+		out[0] = (r << 3) | (r >> 2);
+		out[1] = (g << 2) | (g >> 4);
+		out[2] = (b << 3) | (b >> 2);
+		out[3] = 255;
+	}
+
+	// BC1, and the color half of BC3. Always uses the four color mode, so alpha is dropped.
+	static void EncodeColorBlock(const Block& block, uint8_t* out)
+	{
+		float min[4], max[4];
+		FindEndpoints(block, 3, min, max);
+
+		uint16_t color0 = PackRGB565(max);
+		uint16_t color1 = PackRGB565(min);
+		if (color0 < color1)
+			std::swap(color0, color1);
+
+		uint32_t indices = 0;
+		if (color0 != color1)
+		{
+			int palette[4][4];
+			UnpackRGB565(color0, palette[0]);
+			UnpackRGB565(color1, palette[1]);
+			for (uint32_t c = 0; c < 3; c++)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+			}
+
+			for (uint32_t i = 0; i < 16; i++)
+				indices |= FindClosest<3>(block[i], palette, 4) << (i * 2);
+		}
+
+		memcpy(out, &color0, 2);
+		memcpy(out + 2, &color1, 2);
+		memcpy(out + 4, &indices, 4);
+	}
+
+	// Alpha half of BC3, always uses the eight value mode
+	static void EncodeAlphaBlock(const Block& block, uint8_t* out)
+	{
+		uint8_t alpha0 = 0, alpha1 = 255;
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			alpha0 = std::max(alpha0, block[i][3]);
+			alpha1 = std::min(alpha1, block[i][3]);
+		}
+
+		uint64_t indices = 0;
+		if (alpha0 > alpha1)
+		{
+			int palette[8][4] = {};
+			palette[0][0] = alpha0;
+			palette[1][0] = alpha1;
+			for (uint32_t i = 2; i < 8; i++)
+				palette[i][0] = ((8 - i) * alpha0 + (i - 1) * alpha1) / 7;
+
+			for (uint32_t i = 0; i < 16; i++)
+			{
+				uint8_t alpha[4] = { block[i][3] };
+				indices |= (uint64_t)FindClosest<1>(alpha, palette, 8) << (i * 3);
+			}
+		}
+
+		out[0] = alpha0;
+		out[1] = alpha1;
+		memcpy(out + 2, &indices, 6);
+	}
+
+	// Writes fields least significant bit first, into zeroed memory
+	struct BitWriter
+	{
+		uint8_t* Data;
+		uint32_t Position = 0;
+
+		void Write(uint32_t value, uint32_t bits)
+		{
+			for (uint32_t i = 0; i < bits; i++, Position++)
+			{
+				if ((value >> i) & 1)
+					Data[Position / 8] |= 1 << (Position % 8);
+			}
+		}
+	};
+
+	// BC7 mode 6 only: a single subset with 7 bit RGBA endpoints, a p-bit per endpoint and 4 bit indices
+	static void EncodeBC7Block(const Block& block, uint8_t* out)
+	{
+		static const int weights[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+		float endpoints[2][4];
+		FindEndpoints(block, 4, endpoints[0], endpoints[1]);
+
+		uint32_t quantized[2][4], pBits[2];
+		int unquantized[2][4];
+		for (uint32_t e = 0; e < 2; e++)
+		{
+			float bestError = std::numeric_limits<float>::max();
+			for (uint32_t pBit = 0; pBit < 2; pBit++)
+			{
+				uint32_t values[4];
+				float error = 0.0f;
+				for (uint32_t c = 0; c < 4; c++)
+				{
+					values[c] = (uint32_t)std::clamp((int)std::round((endpoints[e][c] - pBit) / 2.0f), 0, 127);
+					float difference = (float)((values[c] << 1) | pBit) - endpoints[e][c];
+					error += difference * difference;
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					pBits[e] = pBit;
+					for (uint32_t c = 0; c < 4; c++)
+					{
+						quantized[e][c] = values[c];
+						unquantized[e][c] = (int)((values[c] << 1) | pBit);
+					}
+				}
+			}
+		}
+
+		int palette[16][4];
+		for (uint32_t i = 0; i < 16; i++)
+		{
+			for (uint32_t c = 0; c < 4; c++)
+				palette[i][c] = ((64 - weights[i]) * unquantized[0][c] + weights[i] * unquantized[1][c] + 32) >> 6;
+		}
+
+		uint32_t indices[16];
+		for (uint32_t i = 0; i < 16; i++)
+			indices[i] = FindClosest<4>(block[i], palette, 16);
+
+		// The first index is stored without its top bit, so it has to be below 8
+		if (indices[0] & 8)
+		{
+			std::swap(quantized[0], quantized[1]);
+			std::swap(pBits[0], pBits[1]);
+			for (uint32_t i = 0; i < 16; i++)
+				indices[i] = 15 - indices[i];
+		}
+
+		memset(out, 0, 16);
+		BitWriter writer = { out };
+		writer.Write(1 << 6, 7); // Mode 6
+
+		for (uint32_t c = 0; c < 4; c++)
+		{
+			writer.Write(quantized[0][c], 7);
+			writer.Write(quantized[1][c], 7);
+		}
+
+		writer.Write(pBits[0], 1);
+		writer.Write(pBits[1], 1);
+
+		for (uint32_t i = 0; i < 16; i++)
+			writer.Write(indices[i], i == 0 ? 3 : 4);
+	}
+
+	bool TextureCompressor::IsCompressed(ImageFormat format)
+	{
+		return format == ImageFormat::BC1 || format == ImageFormat::BC3 || format == ImageFormat::BC7;
+	}
+
+	uint32_t TextureCompressor::GetMipCount(uint32_t width, uint32_t height)
+	{
+		return (uint32_t)std::floor(std::log2(std::max(width, height))) + 1;
+	}
+
+	uint64_t TextureCompressor::GetLevelSize(ImageFormat format, uint32_t width, uint32_t height)
+	{
+		uint64_t blocks = (uint64_t)((width + 3) / 4) * ((height + 3) / 4);
+		uint64_t texels = (uint64_t)width * height;
+
+		switch (format)
+		{
+			case ImageFormat::R8:      return texels;
+			case ImageFormat::RGB8:    return texels * 3;
+			case ImageFormat::RGBA8:   return texels * 4;
+			case ImageFormat::RGBA32F: return texels * 16;
+			case ImageFormat::BC1:     return blocks * 8;
+			case ImageFormat::BC3:     return blocks * 16;
+			case ImageFormat::BC7:     return blocks * 16;
+		}
+
+		CB_CORE_ASSERT(false, "Unknown ImageFormat!");
+		return 0;
+	}
+
+	uint64_t TextureCompressor::GetChainSize(ImageFormat format, uint32_t width, uint32_t height, uint32_t mipCount)
+	{
+		uint64_t size = 0;
+		for (uint32_t mip = 0; mip < mipCount; mip++)
+			size += GetLevelSize(format, std::max(width >> mip, 1u), std::max(height >> mip, 1u));
+
+		return size;
+	}
+
+	Buffer TextureCompressor::Compress(ImageFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, bool generateMips)
+	{
+		CB_PROFILE_FUNCTION();
+		CB_CORE_ASSERT(IsCompressed(format), "Not a block compressed format!");
+
+		uint32_t mipCount = generateMips ? GetMipCount(width, height) : 1;
+		Buffer result(GetChainSize(format, width, height, mipCount));
+		uint8_t* out = result.Data;
+
+		std::vector<uint8_t> level(rgba, rgba + (size_t)width * height * 4);
+		std::vector<uint8_t> nextLevel;
+
+		for (uint32_t mip = 0; mip < mipCount; mip++)
+		{
+			uint32_t blocksX = (width + 3) / 4;
+			uint32_t blocksY = (height + 3) / 4;
+			uint32_t blockSize = format == ImageFormat::BC1 ? 8 : 16;
+
+			Application::Get().GetThreadPool().ParallelFor(blocksY, [&](uint32_t blockY)
+			{
+				Block block;
+				for (uint32_t blockX = 0; blockX < blocksX; blockX++)
+				{
+					LoadBlock(level.data(), width, height, blockX, blockY, block);
+
+					uint8_t* blockOut = out + ((size_t)blockY * blocksX + blockX) * blockSize;
+					switch (format)
+					{
+						case ImageFormat::BC1: EncodeColorBlock(block, blockOut); break;
+						case ImageFormat::BC3: EncodeAlphaBlock(block, blockOut); EncodeColorBlock(block, blockOut + 8); break;
+						case ImageFormat::BC7: EncodeBC7Block(block, blockOut); break;
+					}
+				}
+			});
+
+			out += (size_t)blocksX * blocksY * blockSize;
+
+			if (mip + 1 < mipCount)
+			{
+				Utils::DownsampleRGBA(level, width, height, nextLevel);
+				level.swap(nextLevel);
+				width = std::max(width / 2, 1u);
+				height = std::max(height / 2, 1u);
+			}
+		}
+
+		return result;
+	}
+
+}
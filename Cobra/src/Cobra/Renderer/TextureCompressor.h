@@ -0,0 +1,24 @@
+#pragma once
+
+#include "Cobra/Renderer/Texture.h"
+
+namespace Cobra {
+
+	// Block compression of RGBA8 images on the CPU, done when a texture is imported. The data of a
+	// compressed texture is its whole mip chain in one buffer, level 0 first.
+	class TextureCompressor
+	{
+	public:
+		static bool IsCompressed(ImageFormat format);
+		static uint32_t GetMipCount(uint32_t width, uint32_t height);
+
+		// Bytes of a single level, and of the first mipCount levels of the chain
+		static uint64_t GetLevelSize(ImageFormat format, uint32_t width, uint32_t height);
+		static uint64_t GetChainSize(ImageFormat format, uint32_t width, uint32_t height, uint32_t mipCount);
+
+		// Encodes the image, and with generateMips every level below it down to 1x1. Blocks at the
+		// right and top edges repeat the edge texels. Rows of blocks are encoded on the thread pool.
+		static Buffer Compress(ImageFormat format, const uint8_t* rgba, uint32_t width, uint32_t height, bool generateMips);
+	};
+
+}
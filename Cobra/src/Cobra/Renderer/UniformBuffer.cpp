@@ -2,6 +2,8 @@
 #include "UniformBuffer.h"
 
 #include "Cobra/Renderer/Renderer.h"
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/Null/NullUniformBuffer.h"
 #include "Platform/OpenGL/OpenGLUniformBuffer.h"
 
 namespace Cobra {
@@ -10,8 +12,8 @@ namespace Cobra {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:    CB_CORE_ASSERT(false, "RendererAPI::None is currently not supported!"); return nullptr;
-			case RendererAPI::API::OpenGL:  return CreateRef<OpenGLUniformBuffer>(size, binding);
+			case RendererAPI::API::None:    return CreateRef<NullUniformBuffer>(size, binding);
+			case RendererAPI::API::OpenGL:  return RenderThread::CreateResource<OpenGLUniformBuffer>(size, binding);
 		}
 
 		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
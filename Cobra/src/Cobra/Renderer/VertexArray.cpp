@@ -2,6 +2,8 @@
 #include "VertexArray.h"
 
 #include "Cobra/Renderer/Renderer.h"
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/Null/NullVertexArray.h"
 #include "Platform/OpenGL/OpenGLVertexArray.h"
 
 namespace Cobra {
@@ -10,8 +12,8 @@ namespace Cobra {
 	{
 		switch (Renderer::GetAPI())
 		{
-			case RendererAPI::API::None:     CB_CORE_ASSERT(false, "RendererAPI::None is currently not supported"); return nullptr;
-			case RendererAPI::API::OpenGL:   return CreateRef<OpenGLVertexArray>();
+			case RendererAPI::API::None:     return CreateRef<NullVertexArray>();
+			case RendererAPI::API::OpenGL:   return RenderThread::CreateResource<OpenGLVertexArray>();
 		}
 
 		CB_CORE_ASSERT(false, "Unknown RendererAPI!");
@@ -63,11 +63,31 @@ namespace Cobra {
 		}
 	};
 
+	// Derived from the transforms up the hierarchy by the scene, never copied or serialized
+	struct WorldTransformComponent
+	{
+		glm::mat4 Transform = glm::mat4(1.0f);
+		uint32_t Version = 0; // Bumped whenever Transform changes
+
+		// Values Transform was computed from
+		TransformComponent Local;
+		UUID Parent = (uint64_t)-1;
+		entt::entity ParentEntity = entt::null;
+		uint32_t ParentVersion = 0;
+		bool Valid = false;
+
+		uint32_t UpdatedPass = 0;
+
+		WorldTransformComponent() = default;
+		WorldTransformComponent(const WorldTransformComponent&) = default;
+	};
+
 	struct SpriteRendererComponent
 	{
 		glm::vec4 Color = { 1.0f, 1.0f, 1.0f, 1.0f };
 		AssetHandle Texture = 0;
 		float TilingFactor = 1.0f;
+		bool Static = false; // Baked into a retained batch, only rebuilt when changed
 
 		SpriteRendererComponent() = default;
 		SpriteRendererComponent(const SpriteRendererComponent&) = default;
@@ -0,0 +1,216 @@
+#include "cbpch.h"
+#include "RenderableIndex.h"
+
+#include "Cobra/Scene/Scene.h"
+#include "Cobra/Scene/Entity.h"
+#include "Cobra/Renderer/Renderer2D.h"
+
+namespace Cobra {
+
+	RenderableIndex::RenderableIndex(Scene* scene, float cellSize)
+		: m_Scene(scene), m_CellSize(cellSize)
+	{ }
+
+	void RenderableIndex::Update(entt::registry& registry)
+	{
+		CB_PROFILE_FUNCTION();
+
+		m_Frame++;
+
+		for (entt::entity entity : registry.view<TransformComponent, SpriteRendererComponent>())
+			UpdateEntity(registry, entity);
+		for (entt::entity entity : registry.view<TransformComponent, CircleRendererComponent>())
+			UpdateEntity(registry, entity);
+		for (entt::entity entity : registry.view<TransformComponent, TextComponent>())
+			UpdateEntity(registry, entity);
+
+		// Entities that were destroyed or lost their renderable components
+		for (auto& [key, cell] : m_Cells)
+		{
+			for (size_t i = cell.Entities.size(); i-- > 0;)
+			{
+				Entry& entry = m_Entries[(uint32_t)entt::to_entity(cell.Entities[i])];
+				if (entry.LastSeenFrame != m_Frame)
+					Remove(entry);
+			}
+		}
+	}
+
+	void RenderableIndex::Query(const Frustum& frustum, std::vector<entt::entity>& outEntities)
+	{
+		CB_PROFILE_FUNCTION();
+
+		for (auto it = m_Cells.begin(); it != m_Cells.end();)
+		{
+			Cell& cell = it->second;
+			if (cell.Entities.empty())
+			{
+				it = m_Cells.erase(it);
+				continue;
+			}
+
+			if (cell.Stale)
+			{
+				cell.BoundsMin = glm::vec3(std::numeric_limits<float>::max());
+				cell.BoundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+
+				for (entt::entity entity : cell.Entities)
+				{
+					const Entry& entry = m_Entries[(uint32_t)entt::to_entity(entity)];
+					cell.BoundsMin = glm::min(cell.BoundsMin, entry.BoundsMin);
+					cell.BoundsMax = glm::max(cell.BoundsMax, entry.BoundsMax);
+				}
+
+				cell.Stale = false;
+			}
+
+			if (frustum.Intersects(cell.BoundsMin, cell.BoundsMax))
+			{
+				for (entt::entity entity : cell.Entities)
+				{
+					const Entry& entry = m_Entries[(uint32_t)entt::to_entity(entity)];
+					if (frustum.Intersects(entry.BoundsMin, entry.BoundsMax))
+						outEntities.push_back(entity);
+				}
+			}
+
+			++it;
+		}
+	}
+
+	void RenderableIndex::UpdateEntity(entt::registry& registry, entt::entity entity)
+	{
+		uint32_t index = (uint32_t)entt::to_entity(entity);
+		if (index >= m_Entries.size())
+			m_Entries.resize(index + 1);
+
+		// Entities with several renderables are visited once per component
+		Entry& entry = m_Entries[index];
+		if (entry.Entity == entity && entry.LastSeenFrame == m_Frame)
+			return;
+
+		auto& world = registry.get<WorldTransformComponent>(entity);
+		auto* sprite = registry.try_get<SpriteRendererComponent>(entity);
+		auto* circle = registry.try_get<CircleRendererComponent>(entity);
+		auto* text = registry.try_get<TextComponent>(entity);
+
+		uint32_t renderables = 0;
+		if (sprite && !sprite->Static)
+			renderables |= RenderableSprite;
+		if (circle)
+			renderables |= RenderableCircle;
+		if (text)
+			renderables |= RenderableText;
+
+		// Left for the sweep in Update to remove
+		if (!renderables)
+			return;
+
+		// World transforms are brought up to date by the scene beforehand, and their version also changes when a parent moves
+		bool changed = entry.Entity != entity || entry.Renderables != renderables || entry.TransformVersion != world.Version;
+
+		if (text)
+			changed |= entry.TextString != text->TextString || entry.FontAsset != text->FontAsset || entry.Kerning != text->Kerning || entry.LineSpacing != text->LineSpacing
+				|| entry.FontGlyphVersion != text->FontAsset->GetGlyphVersion(); // Glyphs generated since may grow the bounds
+
+		if (changed)
+		{
+			// The index may still belong to a destroyed entity
+			if (entry.Entity != entt::null)
+				Remove(entry);
+
+			entry.Entity = entity;
+			entry.Renderables = renderables;
+			entry.TransformVersion = world.Version;
+			entry.WorldTransform = world.Transform;
+
+			glm::vec2 localMin = glm::vec2(std::numeric_limits<float>::max());
+			glm::vec2 localMax = glm::vec2(std::numeric_limits<float>::lowest());
+
+			if (renderables & (RenderableSprite | RenderableCircle))
+			{
+				localMin = glm::min(localMin, glm::vec2(-0.5f));
+				localMax = glm::max(localMax, glm::vec2(0.5f));
+			}
+
+			if (text)
+			{
+				entry.TextString = text->TextString;
+				entry.FontAsset = text->FontAsset;
+				entry.Kerning = text->Kerning;
+				entry.LineSpacing = text->LineSpacing;
+				entry.FontGlyphVersion = text->FontAsset->GetGlyphVersion();
+
+				glm::vec2 textMin, textMax;
+				if (Renderer2D::GetStringBounds(text->TextString, text->FontAsset, { text->Color, text->Kerning, text->LineSpacing }, textMin, textMax))
+				{
+					localMin = glm::min(localMin, textMin);
+					localMax = glm::max(localMax, textMax);
+				}
+			}
+
+			if (localMin.x > localMax.x)
+				localMin = localMax = glm::vec2(0.0f);
+
+			entry.BoundsMin = glm::vec3(std::numeric_limits<float>::max());
+			entry.BoundsMax = glm::vec3(std::numeric_limits<float>::lowest());
+			for (int i = 0; i < 4; i++)
+			{
+				glm::vec4 corner = { i & 1 ? localMax.x : localMin.x, i & 2 ? localMax.y : localMin.y, 0.0f, 1.0f };
+				glm::vec3 worldCorner = entry.WorldTransform * corner;
+
+				entry.BoundsMin = glm::min(entry.BoundsMin, worldCorner);
+				entry.BoundsMax = glm::max(entry.BoundsMax, worldCorner);
+			}
+
+			Insert(entry);
+		}
+
+		entry.LastSeenFrame = m_Frame;
+	}
+
+	void RenderableIndex::Insert(Entry& entry)
+	{
+		entry.Cell = GetCellKey((entry.BoundsMin + entry.BoundsMax) * 0.5f);
+
+		Cell& cell = m_Cells[entry.Cell];
+		if (cell.Entities.empty())
+		{
+			cell.BoundsMin = entry.BoundsMin;
+			cell.BoundsMax = entry.BoundsMax;
+			cell.Stale = false;
+		}
+		else
+		{
+			cell.BoundsMin = glm::min(cell.BoundsMin, entry.BoundsMin);
+			cell.BoundsMax = glm::max(cell.BoundsMax, entry.BoundsMax);
+		}
+
+		entry.Slot = (uint32_t)cell.Entities.size();
+		cell.Entities.push_back(entry.Entity);
+		m_Count++;
+	}
+
+	void RenderableIndex::Remove(Entry& entry)
+	{
+		Cell& cell = m_Cells[entry.Cell];
+
+		entt::entity last = cell.Entities.back();
+		cell.Entities[entry.Slot] = last;
+		m_Entries[(uint32_t)entt::to_entity(last)].Slot = entry.Slot;
+		cell.Entities.pop_back();
+		cell.Stale = true;
+		m_Count--;
+
+		entry.Entity = entt::null;
+	}
+
+	uint64_t RenderableIndex::GetCellKey(const glm::vec3& position) const
+	{
+		int32_t x = (int32_t)std::floor(position.x / m_CellSize);
+		int32_t y = (int32_t)std::floor(position.y / m_CellSize);
+
+		return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)y;
+	}
+
+}
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "Cobra/Scene/Components.h"
+#include "Cobra/Renderer/Frustum.h"
+
+#include <entt.hpp>
+
+namespace Cobra {
+
+	class Scene;
+
+	// Loose grid of the world space bounds of every sprite, circle and text entity. Entities
+	// are stored in the cell containing the center of their bounds and cell bounds grow to
+	// fit them, so the camera frustum only has to be tested against the cells it can see.
+	// Bounds are recomputed when the values they were computed from change.
+	class RenderableIndex
+	{
+	private:
+		enum RenderableFlags : uint32_t
+		{
+			RenderableSprite = 1 << 0, // Static sprites are drawn by the StaticSpriteCache
+			RenderableCircle = 1 << 1,
+			RenderableText   = 1 << 2
+		};
+
+		struct Cell
+		{
+			std::vector<entt::entity> Entities;
+			glm::vec3 BoundsMin = glm::vec3(0.0f);
+			glm::vec3 BoundsMax = glm::vec3(0.0f);
+			bool Stale = false; // Bounds need to be shrunk after a removal
+		};
+
+		struct Entry
+		{
+			entt::entity Entity = entt::null;
+			uint64_t Cell = 0;
+			uint32_t Slot = 0; // Index into the cell's entities
+			uint32_t LastSeenFrame = 0;
+
+			// Values the bounds were computed from
+			uint32_t Renderables = 0;
+			uint32_t TransformVersion = 0;
+			std::string TextString;
+			Ref<Font> FontAsset;
+			float Kerning = 0.0f;
+			float LineSpacing = 0.0f;
+			uint32_t FontGlyphVersion = 0;
+
+			glm::mat4 WorldTransform = glm::mat4(1.0f);
+			glm::vec3 BoundsMin = glm::vec3(0.0f);
+			glm::vec3 BoundsMax = glm::vec3(0.0f);
+		};
+
+		Scene* m_Scene = nullptr;
+		float m_CellSize;
+
+		std::unordered_map<uint64_t, Cell> m_Cells;
+		std::vector<Entry> m_Entries; // Indexed by entity index
+		uint32_t m_Count = 0;
+		uint32_t m_Frame = 0;
+	public:
+		RenderableIndex(Scene* scene, float cellSize = 8.0f);
+
+		// Picks up added, removed and moved renderables
+		void Update(entt::registry& registry);
+		// Appends every renderable entity whose bounds intersect the frustum
+		void Query(const Frustum& frustum, std::vector<entt::entity>& outEntities);
+
+		const glm::mat4& GetWorldTransform(entt::entity entity) const { return m_Entries[(uint32_t)entt::to_entity(entity)].WorldTransform; }
+		uint32_t GetCount() const { return m_Count; }
+	private:
+		void UpdateEntity(entt::registry& registry, entt::entity entity);
+
+		void Insert(Entry& entry);
+		void Remove(Entry& entry);
+		uint64_t GetCellKey(const glm::vec3& position) const;
+	};
+
+}
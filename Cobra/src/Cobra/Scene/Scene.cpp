@@ -4,9 +4,12 @@
 #include "Cobra/Scene/Components.h"
 #include "Cobra/Scene/ScriptableEntity.h"
 #include "Cobra/Scene/Entity.h"
+#include "Cobra/Scene/StaticSpriteCache.h"
+#include "Cobra/Scene/RenderableIndex.h"
 #include "Cobra/Renderer/Renderer2D.h"
 #include "Cobra/Scripting/ScriptEngine.h"
 #include "Cobra/Physics/Physics2D.h"
+#include "Cobra/Asset/AssetManager.h"
 
 #include <glm/glm.hpp>
 #include <box2d/b2_world.h>
@@ -19,7 +22,8 @@ namespace Cobra {
 
 	Scene::Scene()
 	{
-		
+		m_StaticSprites = CreateScope<StaticSpriteCache>(this);
+		m_Renderables = CreateScope<RenderableIndex>(this);
 	}
 
 	Scene::~Scene()
@@ -103,6 +107,7 @@ namespace Cobra {
 		entity.AddComponent<IDComponent>(uuid);
 		entity.AddComponent<RelationshipComponent>();
 		entity.AddComponent<TransformComponent>();
+		entity.AddComponent<WorldTransformComponent>();
 		entity.AddComponent<TagComponent>(name.empty() ? "Entity" : name);
 
 		m_EntityMap[uuid] = entity;
@@ -311,16 +316,51 @@ namespace Cobra {
 
 	glm::mat4 Scene::GetWorldSpaceTransformMatrix(Entity entity)
 	{
-		glm::mat4 retMatrix = entity.GetComponent<TransformComponent>().GetTransform();
+		// Local transforms may have changed since the last pass, a new one only rechecks this entity's parents
+		m_WorldTransformPass++;
+		return UpdateWorldTransform(entity).Transform;
+	}
+
+	void Scene::UpdateWorldTransforms()
+	{
+		CB_PROFILE_FUNCTION();
+
+		m_WorldTransformPass++;
+		for (entt::entity entity : m_Registry.view<WorldTransformComponent>())
+			UpdateWorldTransform(entity);
+	}
+
+	const WorldTransformComponent& Scene::UpdateWorldTransform(entt::entity entity)
+	{
+		auto [transform, relationship, world] = m_Registry.get<TransformComponent, RelationshipComponent, WorldTransformComponent>(entity);
+		if (world.UpdatedPass == m_WorldTransformPass)
+			return world;
+
+		world.UpdatedPass = m_WorldTransformPass;
 
-		UUID parentUUID = entity.GetComponent<RelationshipComponent>().Parent;
-		if (parentUUID != -1)
+		// Only looked up again once the entity is reparented or the parent is destroyed
+		if (world.Parent != relationship.Parent || (world.ParentEntity != entt::null && !m_Registry.valid(world.ParentEntity)))
 		{
-			Entity parent = GetEntityByUUID(parentUUID);
-			retMatrix = GetWorldSpaceTransformMatrix(parent) * retMatrix;
+			world.Parent = relationship.Parent;
+			world.ParentEntity = relationship.Parent != -1 ? (entt::entity)GetEntityByUUID(relationship.Parent) : entt::null;
+			world.Valid = false;
 		}
 
-		return retMatrix;
+		const WorldTransformComponent* parent = world.ParentEntity != entt::null ? &UpdateWorldTransform(world.ParentEntity) : nullptr;
+
+		bool changed = !world.Valid || (parent && world.ParentVersion != parent->Version)
+			|| world.Local.Translation != transform.Translation || world.Local.Rotation != transform.Rotation || world.Local.Scale != transform.Scale;
+
+		if (changed)
+		{
+			world.Local = transform;
+			world.Transform = parent ? parent->Transform * transform.GetTransform() : transform.GetTransform();
+			world.ParentVersion = parent ? parent->Version : 0;
+			world.Valid = true;
+			world.Version++;
+		}
+
+		return world;
 	}
 
 	void Scene::Step(int frames)
@@ -351,43 +391,7 @@ namespace Cobra {
 		if (mainCamera)
 		{
 			Renderer2D::BeginScene(*mainCamera, cameraTransform);
-
-			// Draw sprites
-			{
-				auto group = m_Registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
-				for (auto entity : group)
-				{
-					Entity e = Entity(entity, this);
-					auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
-
-					Renderer2D::DrawSprite(GetWorldSpaceTransformMatrix(e), sprite, (int)entity);
-				}
-			}
-
-			// Draw circles
-			{
-				auto view = m_Registry.view<TransformComponent, CircleRendererComponent>();
-				for (auto entity : view)
-				{
-					Entity e = Entity(entity, this);
-					auto [transform, circle] = view.get<TransformComponent, CircleRendererComponent>(entity);
-
-					Renderer2D::DrawCircle(GetWorldSpaceTransformMatrix(e), circle.Color, circle.Thickness, circle.Fade, (int)entity);
-				}
-			}
-
-			// Draw Text
-			{
-				auto view = m_Registry.view<TransformComponent, TextComponent>();
-				for (auto entity : view)
-				{
-					Entity e = Entity(entity, this);
-					auto [transform, text] = view.get<TransformComponent, TextComponent>(entity);
-
-					Renderer2D::DrawString(text.TextString, GetWorldSpaceTransformMatrix(e), text, (int)entity);
-				}
-			}
-
+			DrawRenderables();
 			Renderer2D::EndScene();
 		}
 	}
@@ -456,43 +460,64 @@ namespace Cobra {
 	void Scene::RenderScene(EditorCamera& camera)
 	{
 		Renderer2D::BeginScene(camera);
-		// Draw sprites
-		{
-			auto group = m_Registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
-			for (auto entity : group)
-			{
-				Entity e = Entity(entity, this);
-				auto [transform, sprite] = group.get<TransformComponent, SpriteRendererComponent>(entity);
+		DrawRenderables();
+		Renderer2D::EndScene();
+	}
 
-				Renderer2D::DrawSprite(GetWorldSpaceTransformMatrix(e), sprite, (int)entity);
-			}
-		}
+	// Records on worker threads, so only reads from the registry are allowed in the recording callbacks
+	void Scene::DrawRenderables()
+	{
+		const Frustum& frustum = Renderer2D::GetFrustum();
 
-		// Draw circles
-		{
-			auto view = m_Registry.view<TransformComponent, CircleRendererComponent>();
-			for (auto entity : view)
-			{
-				Entity e = Entity(entity, this);
-				auto [transform, circle] = view.get<TransformComponent, CircleRendererComponent>(entity);
+		UpdateWorldTransforms();
 
-				Renderer2D::DrawCircle(GetWorldSpaceTransformMatrix(e), circle.Color, circle.Thickness, circle.Fade, (int)entity);
-			}
+		// Draw static sprites, only changed chunks are rebuilt
+		{
+			m_StaticSprites->Update(m_Registry);
+			m_StaticSprites->Draw(frustum);
 		}
 
-		// Draw Text
+		// Only renderables the camera can see are submitted
+		m_Renderables->Update(m_Registry);
+
+		std::vector<entt::entity> visible;
+		m_Renderables->Query(frustum, visible);
+		Renderer2D::AddCulledCount(m_Renderables->GetCount() - (uint32_t)visible.size());
+
+		// Loading a texture creates GPU resources, so sprites with unloaded textures are drawn afterwards on this thread
+		std::mutex deferredMutex;
+		std::vector<entt::entity> deferred;
+
+		Renderer2D::RecordParallel((uint32_t)visible.size(), [&](uint32_t begin, uint32_t end)
 		{
-			auto view = m_Registry.view<TransformComponent, TextComponent>();
-			for (auto entity : view)
+			for (uint32_t i = begin; i < end; i++)
 			{
-				Entity e = Entity(entity, this);
-				auto [transform, text] = view.get<TransformComponent, TextComponent>(entity);
+				entt::entity entity = visible[i];
+				const glm::mat4& transform = m_Renderables->GetWorldTransform(entity);
+
+				if (auto* sprite = m_Registry.try_get<SpriteRendererComponent>(entity); sprite && !sprite->Static)
+				{
+					if (sprite->Texture && !AssetManager::IsAssetLoaded(sprite->Texture))
+					{
+						std::scoped_lock<std::mutex> lock(deferredMutex);
+						deferred.push_back(entity);
+					}
+					else
+					{
+						Renderer2D::DrawSprite(transform, *sprite, (int)entity);
+					}
+				}
+
+				if (auto* circle = m_Registry.try_get<CircleRendererComponent>(entity))
+					Renderer2D::DrawCircle(transform, circle->Color, circle->Thickness, circle->Fade, (int)entity);
 
-				Renderer2D::DrawString(text.TextString, GetWorldSpaceTransformMatrix(e), text, (int)entity);
+				if (auto* text = m_Registry.try_get<TextComponent>(entity))
+					Renderer2D::DrawString(text->TextString, transform, *text, (int)entity);
 			}
-		}
+		});
 
-		Renderer2D::EndScene();
+		for (entt::entity entity : deferred)
+			Renderer2D::DrawSprite(m_Renderables->GetWorldTransform(entity), m_Registry.get<SpriteRendererComponent>(entity), (int)entity);
 	}
 
 	template<typename T>
@@ -513,6 +538,10 @@ namespace Cobra {
 	void Scene::OnComponentAdded<TransformComponent>(Entity entity, TransformComponent& component)
 	{ }
 
+	template<>
+	void Scene::OnComponentAdded<WorldTransformComponent>(Entity entity, WorldTransformComponent& component)
+	{ }
+
 	template<>
 	void Scene::OnComponentAdded<CameraComponent>(Entity entity, CameraComponent& component)
 	{ 
@@ -14,6 +14,9 @@ namespace Cobra {
 	class Entity;
 	class SceneHierarchyPanel;
 	class SceneSerializer;
+	class StaticSpriteCache;
+	class RenderableIndex;
+	struct WorldTransformComponent;
 
 	class Scene : public Asset
 	{
@@ -26,6 +29,9 @@ namespace Cobra {
 		uint32_t m_ViewportWidth = 0, m_ViewportHeight = 0;
 
 		std::unordered_map<UUID, entt::entity> m_EntityMap;
+		uint32_t m_WorldTransformPass = 0;
+		Scope<StaticSpriteCache> m_StaticSprites;
+		Scope<RenderableIndex> m_Renderables;
 
 		b2World* m_PhysicsWorld = nullptr;
 		bool m_IsRunning = false;
@@ -59,7 +65,10 @@ namespace Cobra {
 		Entity FindEntityByName(std::string_view name);
 		Entity GetEntityByUUID(UUID uuid);
 		Entity GetPrimaryCameraEntity();
+		bool IsEntityValid(entt::entity entity) const { return m_Registry.valid(entity); }
 		glm::mat4 GetWorldSpaceTransformMatrix(Entity entity);
+		// Brings every world transform up to date, parents before their children
+		void UpdateWorldTransforms();
 
 		bool IsRunning() const { return m_IsRunning; }
 		bool IsPaused() const { return m_IsPaused; }
@@ -78,10 +87,13 @@ namespace Cobra {
 		template<typename T>
 		void OnComponentAdded(Entity entity, T& component);
 
+		const WorldTransformComponent& UpdateWorldTransform(entt::entity entity);
+
 		void OnPhysics2DStart();
 		void OnPhysics2DStop();
 
 		void RenderScene(EditorCamera& camera);
+		void DrawRenderables();
 	};
 
 }
\ No newline at end of file
@@ -335,6 +335,7 @@ namespace Cobra {
 			out << YAML::Key << "TextureHandle" << YAML::Value << spriteRendererComponent.Texture;
 
 			out << YAML::Key << "TilingFactor" << YAML::Value << spriteRendererComponent.TilingFactor;
+			out << YAML::Key << "Static" << YAML::Value << spriteRendererComponent.Static;
 
 			out << YAML::EndMap; // SpriteRendererComponent
 		}
@@ -586,6 +587,9 @@ namespace Cobra {
 
 					if (spriteRendererComponent["TilingFactor"])
 						src.TilingFactor = spriteRendererComponent["TilingFactor"].as<float>();
+
+					if (spriteRendererComponent["Static"])
+						src.Static = spriteRendererComponent["Static"].as<bool>();
 				}
 
 				auto circleRendererComponent = entity["CircleRendererComponent"];
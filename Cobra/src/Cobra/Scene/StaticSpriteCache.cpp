@@ -0,0 +1,211 @@
+#include "cbpch.h"
+#include "StaticSpriteCache.h"
+
+#include "Cobra/Scene/Scene.h"
+#include "Cobra/Scene/Entity.h"
+#include "Cobra/Asset/AssetManager.h"
+
+namespace Cobra {
+
+	static bool HasChanged(const SpriteRendererComponent& a, const SpriteRendererComponent& b)
+	{
+		return a.Color != b.Color || a.Texture != b.Texture || a.TilingFactor != b.TilingFactor;
+	}
+
+	StaticSpriteCache::StaticSpriteCache(Scene* scene)
+		: m_Scene(scene)
+	{ }
+
+	void StaticSpriteCache::Update(entt::registry& registry)
+	{
+		CB_PROFILE_FUNCTION();
+
+		m_Frame++;
+
+		auto group = registry.group<TransformComponent>(entt::get<SpriteRendererComponent>);
+		for (entt::entity entity : group)
+		{
+			auto& sprite = group.get<SpriteRendererComponent>(entity);
+			if (!sprite.Static)
+				continue;
+
+			// Brought up to date by the scene beforehand, the version also changes when a parent moves
+			auto& world = registry.get<WorldTransformComponent>(entity);
+
+			uint32_t index = (uint32_t)entt::to_entity(entity);
+			if (index >= m_Entries.size())
+				m_Entries.resize(index + 1);
+
+			Entry& entry = m_Entries[index];
+			if (entry.Entity != entity)
+			{
+				// The index may still belong to a destroyed entity
+				if (entry.Entity != entt::null)
+					Remove(entry);
+
+				entry.Entity = entity;
+				entry.TransformVersion = world.Version;
+				entry.Sprite = sprite;
+				entry.WorldTransform = world.Transform;
+				Insert(entry);
+			}
+			else if (entry.TransformVersion != world.Version || HasChanged(entry.Sprite, sprite))
+			{
+				bool textureChanged = entry.Sprite.Texture != sprite.Texture;
+				if (textureChanged)
+					Remove(entry);
+
+				entry.Entity = entity;
+				entry.TransformVersion = world.Version;
+				entry.Sprite = sprite;
+				entry.WorldTransform = world.Transform;
+
+				if (textureChanged)
+					Insert(entry);
+				else
+					m_Chunks[entry.Chunk].Dirty = true;
+			}
+
+			entry.LastSeenFrame = m_Frame;
+		}
+
+		// Sprites that were destroyed or are no longer static
+		for (Chunk& chunk : m_Chunks)
+		{
+			for (size_t i = chunk.Entities.size(); i-- > 0;)
+			{
+				Entry& entry = m_Entries[(uint32_t)entt::to_entity(chunk.Entities[i])];
+				if (entry.LastSeenFrame != m_Frame)
+					Remove(entry);
+			}
+		}
+
+		// Walked backwards, so the chunk moved into a freed slot has already been visited
+		for (size_t i = m_Chunks.size(); i-- > 0;)
+		{
+			if (m_Chunks[i].Entities.empty())
+				FreeChunk((uint32_t)i);
+		}
+
+		for (Chunk& chunk : m_Chunks)
+		{
+			if (chunk.Dirty)
+				Rebuild(chunk);
+		}
+	}
+
+	void StaticSpriteCache::Draw(const Frustum& frustum)
+	{
+		uint32_t culled = 0;
+		for (const Chunk& chunk : m_Chunks)
+		{
+			if (!chunk.Batch || !chunk.Batch->GetCount())
+				continue;
+
+			if (frustum.Intersects(chunk.Batch->GetBoundsMin(), chunk.Batch->GetBoundsMax()))
+				Renderer2D::DrawStaticBatch(chunk.Batch);
+			else
+				culled += chunk.Batch->GetCount();
+		}
+
+		Renderer2D::AddCulledCount(culled);
+	}
+
+	void StaticSpriteCache::Insert(Entry& entry)
+	{
+		std::vector<uint32_t>& textureChunks = m_TextureChunks[entry.Sprite.Texture];
+
+		uint32_t chunkIndex = (uint32_t)m_Chunks.size();
+		for (uint32_t index : textureChunks)
+		{
+			if (m_Chunks[index].Entities.size() < MaxChunkQuads)
+			{
+				chunkIndex = index;
+				break;
+			}
+		}
+
+		if (chunkIndex == m_Chunks.size())
+		{
+			Chunk& chunk = m_Chunks.emplace_back();
+			chunk.Texture = entry.Sprite.Texture;
+			textureChunks.push_back(chunkIndex);
+		}
+
+		Chunk& chunk = m_Chunks[chunkIndex];
+		entry.Chunk = chunkIndex;
+		entry.Slot = (uint32_t)chunk.Entities.size();
+		chunk.Entities.push_back(entry.Entity);
+		chunk.Dirty = true;
+	}
+
+	void StaticSpriteCache::Remove(Entry& entry)
+	{
+		Chunk& chunk = m_Chunks[entry.Chunk];
+
+		entt::entity last = chunk.Entities.back();
+		chunk.Entities[entry.Slot] = last;
+		m_Entries[(uint32_t)entt::to_entity(last)].Slot = entry.Slot;
+		chunk.Entities.pop_back();
+		chunk.Dirty = true;
+
+		entry.Entity = entt::null;
+	}
+
+	void StaticSpriteCache::FreeChunk(uint32_t index)
+	{
+		Chunk& chunk = m_Chunks[index];
+
+		std::vector<uint32_t>& textureChunks = m_TextureChunks[chunk.Texture];
+		textureChunks.erase(std::find(textureChunks.begin(), textureChunks.end(), index));
+		if (textureChunks.empty())
+			m_TextureChunks.erase(chunk.Texture);
+
+		if (chunk.Batch)
+			m_FreeBatches.push_back(std::move(chunk.Batch));
+
+		// The last chunk takes its place
+		uint32_t lastIndex = (uint32_t)m_Chunks.size() - 1;
+		if (index != lastIndex)
+		{
+			Chunk& last = m_Chunks[lastIndex];
+			for (entt::entity entity : last.Entities)
+				m_Entries[(uint32_t)entt::to_entity(entity)].Chunk = index;
+
+			std::vector<uint32_t>& lastTextureChunks = m_TextureChunks[last.Texture];
+			*std::find(lastTextureChunks.begin(), lastTextureChunks.end(), lastIndex) = index;
+
+			chunk = std::move(last);
+		}
+
+		m_Chunks.pop_back();
+	}
+
+	void StaticSpriteCache::Rebuild(Chunk& chunk)
+	{
+		CB_PROFILE_FUNCTION();
+
+		Ref<Texture2D> texture = chunk.Texture ? AssetManager::GetAsset<Texture2D>(chunk.Texture) : nullptr;
+		if (!chunk.Batch && !m_FreeBatches.empty())
+		{
+			chunk.Batch = std::move(m_FreeBatches.back());
+			m_FreeBatches.pop_back();
+		}
+
+		if (!chunk.Batch)
+			chunk.Batch = CreateRef<StaticQuadBatch>(texture, MaxChunkQuads);
+		else
+			chunk.Batch->SetTexture(texture);
+
+		chunk.Batch->Begin();
+		for (entt::entity entity : chunk.Entities)
+		{
+			const Entry& entry = m_Entries[(uint32_t)entt::to_entity(entity)];
+			chunk.Batch->AddQuad(entry.WorldTransform, entry.Sprite.Color, entry.Sprite.TilingFactor, (int)entity);
+		}
+		chunk.Batch->End();
+
+		chunk.Dirty = false;
+	}
+
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "Cobra/Scene/Components.h"
+#include "Cobra/Renderer/Renderer2D.h"
+
+#include <entt.hpp>
+
+namespace Cobra {
+
+	class Scene;
+
+	// Bakes sprites marked as static into per texture chunks that are redrawn every frame
+	// without being rebuilt. Each baked sprite keeps a copy of the values it was baked
+	// with, and a chunk is only rebuilt once one of its sprites no longer matches them.
+	class StaticSpriteCache
+	{
+	private:
+		struct Chunk
+		{
+			AssetHandle Texture = 0;
+			Ref<StaticQuadBatch> Batch;
+			std::vector<entt::entity> Entities;
+			bool Dirty = false;
+		};
+
+		struct Entry
+		{
+			entt::entity Entity = entt::null;
+			uint32_t Chunk = 0;
+			uint32_t Slot = 0; // Index into the chunk's entities
+			uint32_t LastSeenFrame = 0;
+
+			uint32_t TransformVersion = 0;
+			SpriteRendererComponent Sprite;
+			glm::mat4 WorldTransform = glm::mat4(1.0f);
+		};
+
+		static const uint32_t MaxChunkQuads = 4096;
+
+		Scene* m_Scene = nullptr;
+
+		std::vector<Chunk> m_Chunks;
+		std::unordered_map<AssetHandle, std::vector<uint32_t>> m_TextureChunks; // Texture -> chunks
+		std::vector<Ref<StaticQuadBatch>> m_FreeBatches; // Of freed chunks, reused for any texture
+		std::vector<Entry> m_Entries; // Indexed by entity index
+		uint32_t m_Frame = 0;
+	public:
+		StaticSpriteCache(Scene* scene);
+
+		// Picks up added, removed and changed static sprites and rebuilds the chunks they are in
+		void Update(entt::registry& registry);
+		// Submits the chunks intersecting the frustum
+		void Draw(const Frustum& frustum);
+	private:
+		void Insert(Entry& entry);
+		void Remove(Entry& entry);
+		void FreeChunk(uint32_t index);
+		void Rebuild(Chunk& chunk);
+	};
+
+}
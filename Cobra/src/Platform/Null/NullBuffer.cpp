@@ -0,0 +1,69 @@
+#include "cbpch.h"
+#include "NullBuffer.h"
+
+#include "Platform/Null/NullRecording.h"
+
+namespace Cobra {
+
+	////////////////////////////////////////
+	// VertexBuffer ///////////////////////
+	//////////////////////////////////////
+
+	NullVertexBuffer::NullVertexBuffer(uint32_t size)
+		: m_RendererID(NullRecording::NextRendererID()), m_Size(size)
+	{ }
+
+	NullVertexBuffer::NullVertexBuffer(float* vertices, uint32_t size)
+		: m_RendererID(NullRecording::NextRendererID()), m_Size(size)
+	{
+		NullRecording::Get().BufferBytes += size;
+	}
+
+	void NullVertexBuffer::SetData(const void* data, uint32_t size)
+	{
+		CB_CORE_ASSERT(size <= m_Size, "Data does not fit in the vertex buffer!");
+
+		NullRecording::Get().BufferBytes += size;
+	}
+
+	////////////////////////////////////////
+	// StreamingVertexBuffer //////////////
+	//////////////////////////////////////
+
+	NullStreamingVertexBuffer::NullStreamingVertexBuffer(uint32_t regionSize, uint32_t regionCount)
+		: m_RendererID(NullRecording::NextRendererID()), m_Data((size_t)regionSize * regionCount), m_RegionSize(regionSize), m_RegionCount(regionCount)
+	{
+		CB_CORE_ASSERT(regionCount > 0);
+	}
+
+	void NullStreamingVertexBuffer::SetData(const void* data, uint32_t size)
+	{
+		CB_CORE_ASSERT(size <= m_RegionSize, "Data does not fit in a streaming region!");
+
+		memcpy(BeginRegion(), data, size);
+	}
+
+	void* NullStreamingVertexBuffer::BeginRegion()
+	{
+		return m_Data.data() + GetRegionOffset();
+	}
+
+	void NullStreamingVertexBuffer::EndRegion(uint32_t size)
+	{
+		CB_CORE_ASSERT(size <= m_RegionSize);
+
+		NullRecording::Get().StreamedBytes += size;
+		m_CurrentRegion = (m_CurrentRegion + 1) % m_RegionCount;
+	}
+
+	////////////////////////////////////////
+	// IndexBuffer ////////////////////////
+	//////////////////////////////////////
+
+	NullIndexBuffer::NullIndexBuffer(uint32_t* indices, uint32_t count)
+		: m_RendererID(NullRecording::NextRendererID()), m_Count(count)
+	{
+		NullRecording::Get().BufferBytes += count * sizeof(uint32_t);
+	}
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "Cobra/Renderer/Buffer.h"
+
+namespace Cobra {
+
+	class NullVertexBuffer : public VertexBuffer
+	{
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Size;
+		BufferLayout m_Layout;
+	public:
+		NullVertexBuffer(uint32_t size);
+		NullVertexBuffer(float* vertices, uint32_t size);
+
+		void Bind() const override { }
+		void Unbind() const override { }
+
+		void SetData(const void* data, uint32_t size) override;
+
+		void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+		const BufferLayout& GetLayout() const override { return m_Layout; }
+	};
+
+	// Regions are plain memory, so writing vertices costs the same as with a mapped GPU buffer
+	class NullStreamingVertexBuffer : public StreamingVertexBuffer
+	{
+	private:
+		uint32_t m_RendererID;
+		BufferLayout m_Layout;
+
+		std::vector<uint8_t> m_Data;
+		uint32_t m_RegionSize;
+		uint32_t m_RegionCount;
+		uint32_t m_CurrentRegion = 0;
+	public:
+		NullStreamingVertexBuffer(uint32_t regionSize, uint32_t regionCount);
+
+		void Bind() const override { }
+		void Unbind() const override { }
+
+		void SetData(const void* data, uint32_t size) override;
+
+		void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+		const BufferLayout& GetLayout() const override { return m_Layout; }
+
+		void* BeginRegion() override;
+		void EndRegion(uint32_t size) override;
+
+		uint32_t GetRegionOffset() const override { return m_CurrentRegion * m_RegionSize; }
+		uint32_t GetRegionSize() const override { return m_RegionSize; }
+		uint32_t GetRegionCount() const override { return m_RegionCount; }
+	};
+
+	class NullIndexBuffer : public IndexBuffer
+	{
+	private:
+		uint32_t m_RendererID;
+		uint32_t m_Count;
+	public:
+		NullIndexBuffer(uint32_t* indices, uint32_t count);
+
+		void Bind() const override { }
+		void Unbind() const override { }
+
+		uint32_t GetCount() const override { return m_Count; }
+	};
+
+}
@@ -0,0 +1,65 @@
+#include "cbpch.h"
+#include "NullFramebuffer.h"
+
+#include "Cobra/Renderer/RenderCommand.h"
+#include "Platform/Null/NullRecording.h"
+
+namespace Cobra {
+
+	NullFramebuffer::NullFramebuffer(const FramebufferSpecification& spec)
+		: m_Specification(spec)
+	{
+		for (auto format : m_Specification.Attachments.Attachments)
+		{
+			if (format.TextureFormat == FramebufferTextureFormat::DEPTH24STENCIL8)
+				continue;
+
+			m_ColorAttachments.push_back(NullRecording::NextRendererID());
+			m_ClearValues.push_back(0);
+		}
+	}
+
+	void NullFramebuffer::Bind()
+	{
+		NullRecording::Get().FramebufferBinds++;
+		RenderCommand::SetViewport(0, 0, m_Specification.Width, m_Specification.Height);
+	}
+
+	void NullFramebuffer::Resize(uint32_t width, uint32_t height)
+	{
+		m_Specification.Width = width;
+		m_Specification.Height = height;
+	}
+
+	int NullFramebuffer::ReadPixel(uint32_t attachmentIndex, int x, int y)
+	{
+		CB_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size());
+
+		return m_ClearValues[attachmentIndex];
+	}
+
+	void NullFramebuffer::RequestPixel(uint32_t attachmentIndex, int x, int y)
+	{
+		m_RequestedPixel = ReadPixel(attachmentIndex, x, y);
+		m_PixelRequested = true;
+	}
+
+	bool NullFramebuffer::PollPixel(int& outValue)
+	{
+		if (!m_PixelRequested)
+			return false;
+
+		outValue = m_RequestedPixel;
+		m_PixelRequested = false;
+		return true;
+	}
+
+	void NullFramebuffer::ClearAttachment(uint32_t attachmentIndex, int value)
+	{
+		CB_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size());
+
+		m_ClearValues[attachmentIndex] = value;
+		NullRecording::Get().Clears++;
+	}
+
+}
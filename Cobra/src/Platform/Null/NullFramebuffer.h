@@ -0,0 +1,35 @@
+#pragma once
+
+#include "Cobra/Renderer/Framebuffer.h"
+
+namespace Cobra {
+
+	class NullFramebuffer : public Framebuffer
+	{
+	private:
+		FramebufferSpecification m_Specification;
+
+		std::vector<uint32_t> m_ColorAttachments;
+		std::vector<int> m_ClearValues; // Nothing is rasterized, so reads return the last clear value
+
+		int m_RequestedPixel = 0;
+		bool m_PixelRequested = false;
+	public:
+		NullFramebuffer(const FramebufferSpecification& spec);
+
+		void Bind() override;
+		void Unbind() override { }
+
+		void Resize(uint32_t width, uint32_t height) override;
+		int ReadPixel(uint32_t attachmentIndex, int x, int y) override;
+
+		void RequestPixel(uint32_t attachmentIndex, int x, int y) override;
+		bool PollPixel(int& outValue) override;
+
+		void ClearAttachment(uint32_t attachmentIndex, int value) override;
+
+		uint32_t GetColorAttachmentRendererID(uint32_t index = 0) override { CB_CORE_ASSERT(index < m_ColorAttachments.size()); return m_ColorAttachments[index]; }
+		const FramebufferSpecification& GetSpecification() const override { return m_Specification; }
+	};
+
+}
@@ -0,0 +1,19 @@
+#include "cbpch.h"
+#include "NullRecording.h"
+
+namespace Cobra {
+
+	static NullRecording s_Recording;
+	static uint32_t s_NextRendererID = 1;
+
+	NullRecording& NullRecording::Get()
+	{
+		return s_Recording;
+	}
+
+	uint32_t NullRecording::NextRendererID()
+	{
+		return s_NextRendererID++;
+	}
+
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <vector>
+
+namespace Cobra {
+
+	// Everything the null renderer backend was asked to do. Nothing reaches a GPU, so this is
+	// what headless benchmarks measure instead: draw calls, uploaded bytes and state changes.
+	struct NullRecording
+	{
+		enum class DrawType
+		{
+			Indexed = 0,
+			IndexedInstanced
+		};
+
+		struct DrawCall
+		{
+			DrawType Type = DrawType::Indexed;
+			uint32_t VertexArray = 0; // Renderer IDs
+			uint32_t Shader = 0;
+			uint32_t Count = 0; // Indices
+			uint32_t InstanceCount = 1;
+			uint32_t Offset = 0;
+		};
+
+		std::vector<DrawCall> DrawCalls;
+
+		uint64_t BufferBytes = 0; // Vertex and index buffer uploads
+		uint64_t StreamedBytes = 0; // Written into streaming regions
+		uint64_t TextureBytes = 0;
+		uint64_t UniformBufferBytes = 0;
+
+		uint32_t ShaderBinds = 0;
+		uint32_t TextureBinds = 0;
+		uint32_t VertexArrayBinds = 0;
+		uint32_t FramebufferBinds = 0;
+		uint32_t UniformSets = 0;
+		uint32_t ViewportChanges = 0;
+		uint32_t Clears = 0;
+
+		uint32_t BoundShader = 0;
+
+		uint64_t GetDrawnIndices() const
+		{
+			uint64_t count = 0;
+			for (const DrawCall& drawCall : DrawCalls)
+				count += (uint64_t)drawCall.Count * drawCall.InstanceCount;
+
+			return count;
+		}
+
+		// Clears everything recorded so far, renderer IDs keep counting
+		void Reset() { *this = NullRecording(); }
+
+		static NullRecording& Get();
+		static uint32_t NextRendererID();
+	};
+
+}
@@ -0,0 +1,58 @@
+#include "cbpch.h"
+#include "NullRendererAPI.h"
+
+#include "Platform/Null/NullRecording.h"
+#include "Platform/Null/NullVertexArray.h"
+
+namespace Cobra {
+
+	static void RecordDraw(NullRecording::DrawType type, const Ref<VertexArray>& vertexArray, uint32_t count, uint32_t instanceCount, uint32_t offset)
+	{
+		NullRecording& recording = NullRecording::Get();
+		recording.DrawCalls.push_back({ type, ((const NullVertexArray&)*vertexArray).GetRendererID(), recording.BoundShader, count, instanceCount, offset });
+	}
+
+	void NullRendererAPI::Init()
+	{
+		CB_PROFILE_FUNCTION();
+
+		NullRecording::Get().Reset();
+	}
+
+	void NullRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		m_ViewportX = x;
+		m_ViewportY = y;
+		m_ViewportWidth = width;
+		m_ViewportHeight = height;
+
+		NullRecording::Get().ViewportChanges++;
+	}
+
+	void NullRendererAPI::GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) const
+	{
+		x = m_ViewportX;
+		y = m_ViewportY;
+		width = m_ViewportWidth;
+		height = m_ViewportHeight;
+	}
+
+	void NullRendererAPI::Clear() const
+	{
+		NullRecording::Get().Clears++;
+	}
+
+	void NullRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t vertexOffset)
+	{
+		vertexArray->Bind();
+		uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
+
+		RecordDraw(NullRecording::DrawType::Indexed, vertexArray, count, 1, vertexOffset);
+	}
+
+	void NullRendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t instanceOffset)
+	{
+		vertexArray->Bind();
+		RecordDraw(NullRecording::DrawType::IndexedInstanced, vertexArray, indexCount, instanceCount, instanceOffset);
+	}
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "Cobra/Renderer/RendererAPI.h"
+
+namespace Cobra {
+
+	class NullRendererAPI : public RendererAPI
+	{
+	private:
+		uint32_t m_ViewportX = 0, m_ViewportY = 0, m_ViewportWidth = 0, m_ViewportHeight = 0;
+	public:
+		void Init() override;
+		void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		void GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) const override;
+
+		void SetClearColor(const glm::vec4& color) override { }
+		void Clear() const override;
+
+		void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t vertexOffset = 0) override;
+		void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t instanceOffset = 0) override;
+
+		// Nothing reaches a driver, so there is nothing to elide
+		StateStatistics GetStateStatistics() const override { return {}; }
+		void ResetStateStatistics() override { }
+	};
+
+}
@@ -0,0 +1,33 @@
+#include "cbpch.h"
+#include "NullShader.h"
+
+#include "Platform/Null/NullRecording.h"
+
+namespace Cobra {
+
+	NullShader::NullShader(const std::string& filepath, const std::vector<std::string>& defines)
+		: m_RendererID(NullRecording::NextRendererID()), m_Name(std::filesystem::path(filepath).stem().string())
+	{ }
+
+	NullShader::NullShader(const std::string& name, const std::string& vertexSource, const std::string& fragmentSource)
+		: m_RendererID(NullRecording::NextRendererID()), m_Name(name)
+	{ }
+
+	void NullShader::Bind() const
+	{
+		NullRecording& recording = NullRecording::Get();
+		recording.BoundShader = m_RendererID;
+		recording.ShaderBinds++;
+	}
+
+	void NullShader::Unbind() const
+	{
+		NullRecording::Get().BoundShader = 0;
+	}
+
+	void NullShader::RecordUniform()
+	{
+		NullRecording::Get().UniformSets++;
+	}
+
+}
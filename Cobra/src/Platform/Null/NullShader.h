@@ -0,0 +1,45 @@
+#pragma once
+
+#include "Cobra/Renderer/Shader.h"
+
+namespace Cobra {
+
+	// Never compiles anything, binding it only tags the draw calls recorded afterwards
+	class NullShader : public Shader
+	{
+	private:
+		uint32_t m_RendererID;
+		std::string m_Name;
+		ShaderReflection m_Reflection;
+	public:
+		NullShader(const std::string& filepath, const std::vector<std::string>& defines = {});
+		NullShader(const std::string& name, const std::string& vertexSource, const std::string& fragmentSource);
+
+		void Bind() const override;
+		void Unbind() const override;
+
+		void SetInt(const std::string& name, int value) override { RecordUniform(); }
+		void SetIntArray(const std::string& name, int* values, uint32_t count) override { RecordUniform(); }
+		void SetFloat(const std::string& name, float value) override { RecordUniform(); }
+		void SetFloat2(const std::string& name, const glm::vec2& value) override { RecordUniform(); }
+		void SetFloat3(const std::string& name, const glm::vec3& value) override { RecordUniform(); }
+		void SetFloat4(const std::string& name, const glm::vec4& value) override { RecordUniform(); }
+		void SetMat4(const std::string& name, const glm::mat4& value) override { RecordUniform(); }
+
+		ShaderUniformHandle GetUniform(const std::string& name) const override { return {}; }
+
+		void SetInt(ShaderUniformHandle uniform, int value) override { RecordUniform(); }
+		void SetIntArray(ShaderUniformHandle uniform, int* values, uint32_t count) override { RecordUniform(); }
+		void SetFloat(ShaderUniformHandle uniform, float value) override { RecordUniform(); }
+		void SetFloat2(ShaderUniformHandle uniform, const glm::vec2& value) override { RecordUniform(); }
+		void SetFloat3(ShaderUniformHandle uniform, const glm::vec3& value) override { RecordUniform(); }
+		void SetFloat4(ShaderUniformHandle uniform, const glm::vec4& value) override { RecordUniform(); }
+		void SetMat4(ShaderUniformHandle uniform, const glm::mat4& value) override { RecordUniform(); }
+
+		const ShaderReflection& GetReflection() const override { return m_Reflection; }
+		const std::string& GetName() const override { return m_Name; }
+	private:
+		void RecordUniform();
+	};
+
+}
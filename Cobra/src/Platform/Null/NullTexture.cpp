@@ -0,0 +1,52 @@
+#include "cbpch.h"
+#include "NullTexture.h"
+
+#include "Cobra/Renderer/TextureCompressor.h"
+#include "Platform/Null/NullRecording.h"
+
+namespace Cobra {
+
+	NullTexture2D::NullTexture2D(const TextureSpecification& specification, Buffer data)
+		: m_Specification(specification), m_Width(m_Specification.Width), m_Height(m_Specification.Height), m_RendererID(NullRecording::NextRendererID())
+	{
+		if (data)
+			SetData(data);
+	}
+
+	void NullTexture2D::SetData(Buffer data)
+	{
+		// Compressed data is the whole mip chain
+		uint32_t mipCount = m_Specification.GenerateMips && TextureCompressor::IsCompressed(m_Specification.Format) ? TextureCompressor::GetMipCount(m_Width, m_Height) : 1;
+		CB_CORE_ASSERT(data.Size == TextureCompressor::GetChainSize(m_Specification.Format, m_Width, m_Height, mipCount), "Data must be entire texture!");
+
+		NullRecording::Get().TextureBytes += data.Size;
+	}
+
+	void NullTexture2D::SetData(Buffer data, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		CB_CORE_ASSERT(!TextureCompressor::IsCompressed(m_Specification.Format), "Compressed textures can only be uploaded whole!");
+		CB_CORE_ASSERT(x + width <= m_Width && y + height <= m_Height, "Region must be inside the texture!");
+		CB_CORE_ASSERT(data.Size == TextureCompressor::GetLevelSize(m_Specification.Format, width, height), "Data must be entire region!");
+
+		NullRecording::Get().TextureBytes += data.Size;
+	}
+
+	void NullTexture2D::Clear()
+	{
+		CB_CORE_ASSERT(!TextureCompressor::IsCompressed(m_Specification.Format), "Compressed textures can not be cleared!");
+	}
+
+	void NullTexture2D::CopyFrom(const Texture& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height, uint32_t x, uint32_t y)
+	{
+		CB_CORE_ASSERT(source.GetSpecification().Format == m_Specification.Format, "Textures must have the same format!");
+		CB_CORE_ASSERT(x + width <= m_Width && y + height <= m_Height, "Region must be inside the texture!");
+
+		NullRecording::Get().TextureBytes += TextureCompressor::GetLevelSize(m_Specification.Format, width, height);
+	}
+
+	void NullTexture2D::Bind(uint32_t slot) const
+	{
+		NullRecording::Get().TextureBinds++;
+	}
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <Cobra/Renderer/Texture.h>
+
+namespace Cobra {
+
+	class NullTexture2D : public Texture2D
+	{
+	private:
+		TextureSpecification m_Specification;
+
+		uint32_t m_Width, m_Height;
+		uint32_t m_RendererID;
+	public:
+		NullTexture2D(const TextureSpecification& specification, Buffer data = Buffer());
+
+		const TextureSpecification& GetSpecification() const override { return m_Specification; }
+
+		uint32_t GetWidth() const override { return m_Width; }
+		uint32_t GetHeight() const override { return m_Height; }
+		uint32_t GetRendererID() const override { return m_RendererID; }
+
+		void SetData(Buffer data) override;
+		void SetDataAsync(Buffer data) override { SetData(data); }
+		void SetData(Buffer data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		void Clear() override;
+		void CopyFrom(const Texture& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height, uint32_t x, uint32_t y) override;
+		void RegenerateMips() override { }
+
+		void Bind(uint32_t slot = 0) const override;
+
+		bool IsLoaded() const override { return true; }
+
+		bool operator==(const Texture& other) const override
+		{
+			return m_RendererID == other.GetRendererID();
+		}
+	};
+
+}
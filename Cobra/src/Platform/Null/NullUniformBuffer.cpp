@@ -0,0 +1,19 @@
+#include "cbpch.h"
+#include "NullUniformBuffer.h"
+
+#include "Platform/Null/NullRecording.h"
+
+namespace Cobra {
+
+	NullUniformBuffer::NullUniformBuffer(uint32_t size, uint32_t binding)
+		: m_Size(size)
+	{ }
+
+	void NullUniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
+	{
+		CB_CORE_ASSERT(offset + size <= m_Size, "Data does not fit in the uniform buffer!");
+
+		NullRecording::Get().UniformBufferBytes += size;
+	}
+
+}
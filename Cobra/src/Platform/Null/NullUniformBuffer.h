@@ -0,0 +1,16 @@
+#pragma once
+
+#include "Cobra/Renderer/UniformBuffer.h"
+
+namespace Cobra {
+
+	class NullUniformBuffer : public UniformBuffer
+	{
+	private:
+		uint32_t m_Size;
+	public:
+		NullUniformBuffer(uint32_t size, uint32_t binding);
+
+		virtual void SetData(const void* data, uint32_t size, uint32_t offset = 0) override;
+	};
+}
@@ -0,0 +1,24 @@
+#include "cbpch.h"
+#include "NullVertexArray.h"
+
+#include "Platform/Null/NullRecording.h"
+
+namespace Cobra {
+
+	NullVertexArray::NullVertexArray()
+		: m_RendererID(NullRecording::NextRendererID())
+	{ }
+
+	void NullVertexArray::Bind() const
+	{
+		NullRecording::Get().VertexArrayBinds++;
+	}
+
+	void NullVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, VertexInputRate inputRate)
+	{
+		CB_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
+
+		m_VertexBuffers.push_back(vertexBuffer);
+	}
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "Cobra/Renderer/VertexArray.h"
+
+namespace Cobra {
+
+	class NullVertexArray : public VertexArray
+	{
+	private:
+		uint32_t m_RendererID;
+
+		std::vector<Ref<VertexBuffer>> m_VertexBuffers;
+		Ref<IndexBuffer> m_IndexBuffer;
+	public:
+		NullVertexArray();
+
+		void Bind() const override;
+		void Unbind() const override { }
+
+		void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, VertexInputRate inputRate = VertexInputRate::PerVertex) override;
+		void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) override { m_IndexBuffer = indexBuffer; }
+
+		const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const override { return m_VertexBuffers; }
+		const Ref<IndexBuffer>& GetIndexBuffer() const override { return m_IndexBuffer; }
+
+		uint32_t GetRendererID() const { return m_RendererID; }
+	};
+
+}
@@ -1,6 +1,9 @@
 #include "cbpch.h"
 #include "OpenGLBuffer.h"
 
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
 namespace Cobra {
@@ -14,7 +17,7 @@ namespace Cobra {
 		CB_PROFILE_FUNCTION();
 
 		glCreateBuffers(1, &m_RendererID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+		OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, size, nullptr, GL_DYNAMIC_DRAW);
 	}
 
@@ -23,7 +26,7 @@ namespace Cobra {
 		CB_PROFILE_FUNCTION();
 
 		glCreateBuffers(1, &m_RendererID);
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+		OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ARRAY_BUFFER, size, vertices, GL_STATIC_DRAW);
 	}
 
@@ -31,6 +34,7 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
+		OpenGLStateCache::OnBufferDeleted(m_RendererID);
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
@@ -38,20 +42,110 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+		RenderThread::Submit([this]() { OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID); });
 	}
 
 	void OpenGLVertexBuffer::Unbind() const
 	{
 		CB_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		RenderThread::Submit([]() { OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0); });
 	}
 
 	void OpenGLVertexBuffer::SetData(const void* data, uint32_t size)
 	{
-		glBindBuffer(GL_ARRAY_BUFFER, m_RendererID);
-		glBufferSubData(GL_ARRAY_BUFFER, 0, size, data);
+		RenderThread::Submit(Buffer(data, size), [this](Buffer data)
+		{
+			OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID);
+			glBufferSubData(GL_ARRAY_BUFFER, 0, data.Size, data.Data);
+		});
+	}
+
+	////////////////////////////////////////
+	// StreamingVertexBuffer //////////////
+	//////////////////////////////////////
+
+	OpenGLStreamingVertexBuffer::OpenGLStreamingVertexBuffer(uint32_t regionSize, uint32_t regionCount)
+		: m_RegionSize(regionSize), m_Fences(regionCount, nullptr)
+	{
+		CB_PROFILE_FUNCTION();
+		CB_CORE_ASSERT(regionCount > 0);
+
+		GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+		GLsizeiptr size = (GLsizeiptr)regionSize * regionCount;
+
+		glCreateBuffers(1, &m_RendererID);
+		glNamedBufferStorage(m_RendererID, size, nullptr, flags);
+		m_MappedData = (uint8_t*)glMapNamedBufferRange(m_RendererID, 0, size, flags);
+		CB_CORE_ASSERT(m_MappedData, "Failed to persistently map streaming vertex buffer!");
+	}
+
+	OpenGLStreamingVertexBuffer::~OpenGLStreamingVertexBuffer()
+	{
+		CB_PROFILE_FUNCTION();
+
+		for (GLsync fence : m_Fences)
+		{
+			if (fence)
+				glDeleteSync(fence);
+		}
+
+		glUnmapNamedBuffer(m_RendererID);
+		OpenGLStateCache::OnBufferDeleted(m_RendererID);
+		glDeleteBuffers(1, &m_RendererID);
+	}
+
+	void OpenGLStreamingVertexBuffer::Bind() const
+	{
+		CB_PROFILE_FUNCTION();
+
+		RenderThread::Submit([this]() { OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, m_RendererID); });
+	}
+
+	void OpenGLStreamingVertexBuffer::Unbind() const
+	{
+		CB_PROFILE_FUNCTION();
+
+		RenderThread::Submit([]() { OpenGLStateCache::BindBuffer(GL_ARRAY_BUFFER, 0); });
+	}
+
+	void OpenGLStreamingVertexBuffer::SetData(const void* data, uint32_t size)
+	{
+		CB_CORE_ASSERT(size <= m_RegionSize, "Data does not fit in a streaming region!");
+
+		RenderThread::Submit(Buffer(data, size), [this](Buffer data) { memcpy(BeginRegion(), data.Data, data.Size); });
+	}
+
+	// Regions are written directly, so these run on the thread that owns the context
+	void* OpenGLStreamingVertexBuffer::BeginRegion()
+	{
+		WaitForRegion(m_CurrentRegion);
+		return m_MappedData + GetRegionOffset();
+	}
+
+	void OpenGLStreamingVertexBuffer::EndRegion(uint32_t size)
+	{
+		m_Fences[m_CurrentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_CurrentRegion = (m_CurrentRegion + 1) % (uint32_t)m_Fences.size();
+	}
+
+	void OpenGLStreamingVertexBuffer::WaitForRegion(uint32_t region)
+	{
+		GLsync& fence = m_Fences[region];
+		if (!fence)
+			return;
+
+		CB_PROFILE_FUNCTION();
+
+		// Only flush on the first attempt, after that the fence is guaranteed to be submitted
+		GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 0);
+		while (result == GL_TIMEOUT_EXPIRED)
+			result = glClientWaitSync(fence, 0, 1000000); // 1 ms
+
+		CB_CORE_ASSERT(result != GL_WAIT_FAILED, "Waiting on streaming region fence failed!");
+
+		glDeleteSync(fence);
+		fence = nullptr;
 	}
 
 	////////////////////////////////////////
@@ -64,7 +158,7 @@ namespace Cobra {
 		CB_PROFILE_FUNCTION();
 
 		glCreateBuffers(1, &m_RendererID);
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+		OpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
 		glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
 	}
 
@@ -72,6 +166,7 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
+		OpenGLStateCache::OnBufferDeleted(m_RendererID);
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
@@ -79,14 +174,14 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID);
+		RenderThread::Submit([this]() { OpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_RendererID); });
 	}
 
 	void OpenGLIndexBuffer::Unbind() const
 	{
 		CB_PROFILE_FUNCTION();
 
-		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+		RenderThread::Submit([]() { OpenGLStateCache::BindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); });
 	}
 
 }
\ No newline at end of file
@@ -2,6 +2,8 @@
 
 #include "Cobra/Renderer/Buffer.h"
 
+#include <glad/glad.h>
+
 namespace Cobra {
 
 	class OpenGLVertexBuffer : public VertexBuffer
@@ -23,6 +25,38 @@ namespace Cobra {
 		const BufferLayout& GetLayout() const override { return m_Layout; }
 	};
 
+	class OpenGLStreamingVertexBuffer : public StreamingVertexBuffer
+	{
+	private:
+		uint32_t m_RendererID;
+		BufferLayout m_Layout;
+
+		uint8_t* m_MappedData = nullptr;
+		uint32_t m_RegionSize;
+		uint32_t m_CurrentRegion = 0;
+		std::vector<GLsync> m_Fences;
+	public:
+		OpenGLStreamingVertexBuffer(uint32_t regionSize, uint32_t regionCount);
+		virtual ~OpenGLStreamingVertexBuffer();
+
+		void Bind() const override;
+		void Unbind() const override;
+
+		void SetData(const void* data, uint32_t size) override;
+
+		void SetLayout(const BufferLayout& layout) override { m_Layout = layout; }
+		const BufferLayout& GetLayout() const override { return m_Layout; }
+
+		void* BeginRegion() override;
+		void EndRegion(uint32_t size) override;
+
+		uint32_t GetRegionOffset() const override { return m_CurrentRegion * m_RegionSize; }
+		uint32_t GetRegionSize() const override { return m_RegionSize; }
+		uint32_t GetRegionCount() const override { return (uint32_t)m_Fences.size(); }
+	private:
+		void WaitForRegion(uint32_t region);
+	};
+
 	class OpenGLIndexBuffer : public IndexBuffer
 	{
 	private:
@@ -42,4 +42,14 @@ namespace Cobra {
 		glfwSwapBuffers(m_WindowHandle);
 	}
 
+	void OpenGLContext::MakeCurrent()
+	{
+		glfwMakeContextCurrent(m_WindowHandle);
+	}
+
+	void OpenGLContext::ReleaseCurrent()
+	{
+		glfwMakeContextCurrent(nullptr);
+	}
+
 }
\ No newline at end of file
@@ -15,6 +15,9 @@ namespace Cobra {
 
 		void Init() override;
 		void SwapBuffers() override;
+
+		void MakeCurrent() override;
+		void ReleaseCurrent() override;
 	};
 
 }
\ No newline at end of file
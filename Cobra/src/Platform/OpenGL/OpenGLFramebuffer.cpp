@@ -1,6 +1,9 @@
 #include "cbpch.h"
 #include "OpenGLFramebuffer.h"
 
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
 namespace Cobra {
@@ -19,51 +22,47 @@ namespace Cobra {
 			glCreateTextures(TextureTarget(multisampled), count, outID);
 		}
 
-		static void BindTexture(bool multisampled, uint32_t id)
-		{
-			glBindTexture(TextureTarget(multisampled), id);
-		}
-
-		static void AttachColorTexture(uint32_t id, int samples, GLenum internalFormat, GLenum format, uint32_t width, uint32_t height, int index)
+		// Created with DSA, so neither the textures nor the framebuffer are bound behind the state cache's back
+		static void AttachColorTexture(uint32_t framebuffer, uint32_t id, int samples, GLenum internalFormat, uint32_t width, uint32_t height, int index)
 		{
 			bool multisampled = samples > 1;
 			if (multisampled)
 			{
-				glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, samples, internalFormat, width, height, GL_FALSE);
+				glTextureStorage2DMultisample(id, samples, internalFormat, width, height, GL_FALSE);
 			}
 			else
 			{
-				glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, width, height, 0, format, GL_UNSIGNED_BYTE, nullptr);
+				glTextureStorage2D(id, 1, internalFormat, width, height);
 
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(id, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+				glTextureParameteri(id, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 			}
 
-			glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0 + index, TextureTarget(multisampled), id, 0);
+			glNamedFramebufferTexture(framebuffer, GL_COLOR_ATTACHMENT0 + index, id, 0);
 		}
 
-		static void AttachDepthTexture(uint32_t id, int samples, GLenum format, GLenum attachmentType, uint32_t width, uint32_t height)
+		static void AttachDepthTexture(uint32_t framebuffer, uint32_t id, int samples, GLenum format, GLenum attachmentType, uint32_t width, uint32_t height)
 		{
 			bool multisampled = samples > 1;
 			if (multisampled)
 			{
-				glTexImage2DMultisample(GL_TEXTURE_2D_MULTISAMPLE, samples, format, width, height, GL_FALSE);
+				glTextureStorage2DMultisample(id, samples, format, width, height, GL_FALSE);
 			}
 			else
 			{
-				glTexStorage2D(GL_TEXTURE_2D, 1, format, width, height);
+				glTextureStorage2D(id, 1, format, width, height);
 
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(id, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glTextureParameteri(id, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+				glTextureParameteri(id, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(id, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTextureParameteri(id, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 			}
 
-			glFramebufferTexture2D(GL_FRAMEBUFFER, attachmentType, TextureTarget(multisampled), id, 0);
+			glNamedFramebufferTexture(framebuffer, attachmentType, id, 0);
 		}
 
 		static bool IsDepthFormat(FramebufferTextureFormat format)
@@ -107,8 +106,18 @@ namespace Cobra {
 	OpenGLFramebuffer::~OpenGLFramebuffer()
 	{
 		glDeleteFramebuffers(1, &m_RendererID);
+		OpenGLStateCache::OnTexturesDeleted((uint32_t)m_ColorAttachments.size(), m_ColorAttachments.data());
+		OpenGLStateCache::OnTexturesDeleted(1, &m_DepthAttachment);
 		glDeleteTextures(m_ColorAttachments.size(), m_ColorAttachments.data());
 		glDeleteTextures(1, &m_DepthAttachment);
+
+		for (PixelRead& read : m_PixelReads)
+		{
+			if (read.Fence)
+				glDeleteSync(read.Fence);
+			OpenGLStateCache::OnBufferDeleted(read.Buffer);
+			glDeleteBuffers(1, &read.Buffer);
+		}
 	}
 
 	void OpenGLFramebuffer::Invalidate()
@@ -118,6 +127,8 @@ namespace Cobra {
 		if (m_RendererID)
 		{
 			glDeleteFramebuffers(1, &m_RendererID);
+			OpenGLStateCache::OnTexturesDeleted((uint32_t)m_ColorAttachments.size(), m_ColorAttachments.data());
+			OpenGLStateCache::OnTexturesDeleted(1, &m_DepthAttachment);
 			glDeleteTextures(m_ColorAttachments.size(), m_ColorAttachments.data());
 			glDeleteTextures(1, &m_DepthAttachment);
 
@@ -126,7 +137,6 @@ namespace Cobra {
 		}
 
 		glCreateFramebuffers(1, &m_RendererID);
-		glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
 
 		bool multisample = m_Specification.Samples > 1;
 
@@ -138,14 +148,13 @@ namespace Cobra {
 
 			for (size_t i = 0; i < m_ColorAttachments.size(); i++)
 			{
-				Utils::BindTexture(multisample, m_ColorAttachments[i]);
 				switch (m_ColorAttachmentSpecifications[i].TextureFormat)
 				{
 					case FramebufferTextureFormat::RGBA8:
-						Utils::AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_RGBA8, GL_RGBA, m_Specification.Width, m_Specification.Height, i);
+						Utils::AttachColorTexture(m_RendererID, m_ColorAttachments[i], m_Specification.Samples, GL_RGBA8, m_Specification.Width, m_Specification.Height, i);
 						break;
 					case FramebufferTextureFormat::RED_INTEGER:
-						Utils::AttachColorTexture(m_ColorAttachments[i], m_Specification.Samples, GL_R32I, GL_RED_INTEGER, m_Specification.Width, m_Specification.Height, i);
+						Utils::AttachColorTexture(m_RendererID, m_ColorAttachments[i], m_Specification.Samples, GL_R32I, m_Specification.Width, m_Specification.Height, i);
 						break;
 				}
 			}
@@ -154,12 +163,11 @@ namespace Cobra {
 		if (m_DepthAttachmentSpecification.TextureFormat != FramebufferTextureFormat::None)
 		{
 			Utils::CreateTextures(multisample, &m_DepthAttachment, 1);
-			Utils::BindTexture(multisample, m_DepthAttachment);
 
 			switch (m_DepthAttachmentSpecification.TextureFormat)
 			{
 				case FramebufferTextureFormat::DEPTH24STENCIL8:
-					Utils::AttachDepthTexture(m_DepthAttachment, m_Specification.Samples, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL_ATTACHMENT, m_Specification.Width, m_Specification.Height);
+					Utils::AttachDepthTexture(m_RendererID, m_DepthAttachment, m_Specification.Samples, GL_DEPTH24_STENCIL8, GL_DEPTH_STENCIL_ATTACHMENT, m_Specification.Width, m_Specification.Height);
 					break;
 			}
 		}
@@ -169,27 +177,29 @@ namespace Cobra {
 			CB_CORE_ASSERT(m_ColorAttachments.size() <= 4);
 
 			GLenum buffers[4] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3 };
-			glDrawBuffers(m_ColorAttachments.size(), buffers);
+			glNamedFramebufferDrawBuffers(m_RendererID, m_ColorAttachments.size(), buffers);
 		}
 		else if (m_ColorAttachments.empty())
 		{
 			// Only depth-pass
-			glDrawBuffer(GL_NONE);
+			glNamedFramebufferDrawBuffer(m_RendererID, GL_NONE);
 		}
 
-		CB_CORE_ASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		CB_CORE_ASSERT(glCheckNamedFramebufferStatus(m_RendererID, GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Framebuffer is incomplete!");
 	}
 
 	void OpenGLFramebuffer::Bind()
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
-		glViewport(0, 0, m_Specification.Width, m_Specification.Height);
+		RenderThread::Submit([this]()
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, m_RendererID);
+			glViewport(0, 0, m_Specification.Width, m_Specification.Height);
+		});
 	}
 
 	void OpenGLFramebuffer::Unbind()
 	{
-		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		RenderThread::Submit([]() { glBindFramebuffer(GL_FRAMEBUFFER, 0); });
 	}
 
 	void OpenGLFramebuffer::Resize(uint32_t width, uint32_t height)
@@ -200,10 +210,15 @@ namespace Cobra {
 			return;
 		}
 
-		m_Specification.Width = width;
-		m_Specification.Height = height;
+		// The attachment IDs are handed out right after, so this can not wait for the recorded frame to execute.
+		// Frames kicked before still draw into the old attachments.
+		RenderThread::ExecuteAfterFrames([&]()
+		{
+			m_Specification.Width = width;
+			m_Specification.Height = height;
 
-		Invalidate();
+			Invalidate();
+		});
 	}
 
 	int OpenGLFramebuffer::ReadPixel(uint32_t attachmentIndex, int x, int y)
@@ -211,18 +226,106 @@ namespace Cobra {
 		CB_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size());
 		int pixelData;
 
-		glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentIndex);
-		glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_INT, &pixelData);
+		// Reads what the kicked frames have drawn, not the frame being recorded. Between frames this
+		// framebuffer is generally no longer bound, so it is bound for reading just for the read.
+		RenderThread::ExecuteAfterFrames([&]()
+		{
+			GLint previousReadFramebuffer;
+			glGetIntegerv(GL_READ_FRAMEBUFFER_BINDING, &previousReadFramebuffer);
+
+			glNamedFramebufferReadBuffer(m_RendererID, GL_COLOR_ATTACHMENT0 + attachmentIndex);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, m_RendererID);
+			glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_INT, &pixelData);
+			glBindFramebuffer(GL_READ_FRAMEBUFFER, previousReadFramebuffer);
+		});
 
 		return pixelData;
 	}
 
+	void OpenGLFramebuffer::RequestPixel(uint32_t attachmentIndex, int x, int y)
+	{
+		CB_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size());
+
+		RenderThread::Submit([this, attachmentIndex, x, y]()
+		{
+			PixelRead& read = m_PixelReads[m_NextPixelRead];
+			if (read.Fence)
+				return;
+
+			if (!read.Buffer)
+			{
+				glCreateBuffers(1, &read.Buffer);
+				glNamedBufferStorage(read.Buffer, sizeof(int), nullptr, 0);
+			}
+
+			// With a pack buffer bound glReadPixels returns immediately and writes into the buffer
+			OpenGLStateCache::BindBuffer(GL_PIXCB_PACK_BUFFER, read.Buffer); // GL_PIXEL_PACK_BUFFER, as named by our glad
+			glReadBuffer(GL_COLOR_ATTACHMENT0 + attachmentIndex);
+			glReadPixels(x, y, 1, 1, GL_RED_INTEGER, GL_INT, nullptr);
+			OpenGLStateCache::BindBuffer(GL_PIXCB_PACK_BUFFER, 0);
+
+			read.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			m_NextPixelRead = (m_NextPixelRead + 1) % MaxPixelReads;
+		});
+	}
+
+	bool OpenGLFramebuffer::PollPixel(int& outValue)
+	{
+		// Reads finish on the render thread, a poll picks up what the polls executed before it found
+		RenderThread::Submit([this]()
+		{
+			int value;
+			if (PollPixelReads(value))
+			{
+				std::scoped_lock<std::mutex> lock(m_PolledPixelMutex);
+				m_PolledPixel = value;
+				m_HasPolledPixel = true;
+			}
+		});
+
+		std::scoped_lock<std::mutex> lock(m_PolledPixelMutex);
+		if (!m_HasPolledPixel)
+			return false;
+
+		outValue = m_PolledPixel;
+		m_HasPolledPixel = false;
+		return true;
+	}
+
+	bool OpenGLFramebuffer::PollPixelReads(int& outValue)
+	{
+		bool found = false;
+
+		// Oldest first, so the last one copied out is the most recent
+		for (uint32_t i = 0; i < MaxPixelReads; i++)
+		{
+			PixelRead& read = m_PixelReads[(m_NextPixelRead + i) % MaxPixelReads];
+			if (!read.Fence)
+				continue;
+
+			GLenum result = glClientWaitSync(read.Fence, 0, 0);
+			if (result != GL_ALREADY_SIGNALED && result != GL_CONDITION_SATISFIED)
+				break;
+
+			glDeleteSync(read.Fence);
+			read.Fence = nullptr;
+
+			glGetNamedBufferSubData(read.Buffer, 0, sizeof(int), &outValue);
+			found = true;
+		}
+
+		return found;
+	}
+
 	void OpenGLFramebuffer::ClearAttachment(uint32_t attachmentIndex, int value)
 	{
 		CB_CORE_ASSERT(attachmentIndex < m_ColorAttachments.size());
 
-		auto& spec = m_ColorAttachmentSpecifications[attachmentIndex];
-		glClearTexImage(m_ColorAttachments[attachmentIndex], 0, Utils::CobraFBTextureFormatToGL(spec.TextureFormat), GL_INT, &value);
+		RenderThread::Submit([this, attachmentIndex, value]()
+		{
+			auto& spec = m_ColorAttachmentSpecifications[attachmentIndex];
+			glClearTexImage(m_ColorAttachments[attachmentIndex], 0, Utils::CobraFBTextureFormatToGL(spec.TextureFormat), GL_INT, &value);
+		});
 	}
 
 }
\ No newline at end of file
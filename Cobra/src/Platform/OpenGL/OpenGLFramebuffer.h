@@ -2,11 +2,23 @@
 
 #include "Cobra/Renderer/Framebuffer.h"
 
+#include <glad/glad.h>
+
+#include <mutex>
+
 namespace Cobra {
 
 	class OpenGLFramebuffer : public Framebuffer
 	{
 	private:
+		struct PixelRead
+		{
+			uint32_t Buffer = 0;
+			GLsync Fence = nullptr; // Set while the read is in flight
+		};
+
+		static const uint32_t MaxPixelReads = 3;
+
 		uint32_t m_RendererID = 0;
 		FramebufferSpecification m_Specification;
 
@@ -15,6 +27,14 @@ namespace Cobra {
 
 		std::vector<uint32_t> m_ColorAttachments;
 		uint32_t m_DepthAttachment = 0;
+
+		PixelRead m_PixelReads[MaxPixelReads];
+		uint32_t m_NextPixelRead = 0; // Reads are issued and finish in ring order
+
+		// Latest pixel found by the render thread, until PollPixel hands it out
+		std::mutex m_PolledPixelMutex;
+		int m_PolledPixel = 0;
+		bool m_HasPolledPixel = false;
 	public:
 		OpenGLFramebuffer(const FramebufferSpecification& spec);
 		virtual ~OpenGLFramebuffer();
@@ -27,10 +47,15 @@ namespace Cobra {
 		void Resize(uint32_t width, uint32_t height) override;
 		int ReadPixel(uint32_t attachmentIndex, int x, int y) override;
 
+		void RequestPixel(uint32_t attachmentIndex, int x, int y) override;
+		bool PollPixel(int& outValue) override;
+
 		void ClearAttachment(uint32_t attachmentIndex, int value) override;
 
 		uint32_t GetColorAttachmentRendererID(uint32_t index = 0) override { CB_CORE_ASSERT(index < m_ColorAttachments.size()); return m_ColorAttachments[index]; }
 		const FramebufferSpecification& GetSpecification() const override { return m_Specification; }
+	private:
+		bool PollPixelReads(int& outValue);
 	};
 
 }
\ No newline at end of file
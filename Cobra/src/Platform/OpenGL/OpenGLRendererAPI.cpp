@@ -1,6 +1,8 @@
 #include "cbpch.h"
 #include "OpenGLRendererAPI.h"
 
+#include "Platform/OpenGL/OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
 namespace Cobra {
@@ -37,11 +39,10 @@ namespace Cobra {
 		glDebugMessageControl(GL_DONT_CARE, GL_DONT_CARE, GL_DEBUG_SEVERITY_NOTIFICATION, 0, NULL, GL_FALSE);
 #endif
 
-		glEnable(GL_BLEND);
-		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		OpenGLStateCache::SetBlend(true);
+		OpenGLStateCache::SetBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
 		glEnable(GL_DEPTH_TEST);
-		glEnable(GL_LINE_SMOOTH);
 	}
 
 	void OpenGLRendererAPI::SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height)
@@ -49,6 +50,18 @@ namespace Cobra {
 		glViewport(x, y, width, height);
 	}
 
+	void OpenGLRendererAPI::GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) const
+	{
+		// Framebuffers set their own viewport when bound, so it is read back rather than tracked
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+
+		x = (uint32_t)viewport[0];
+		y = (uint32_t)viewport[1];
+		width = (uint32_t)viewport[2];
+		height = (uint32_t)viewport[3];
+	}
+
 	void OpenGLRendererAPI::SetClearColor(const glm::vec4& color)
 	{
 		glClearColor(color.r, color.g, color.b, color.a);
@@ -59,22 +72,27 @@ namespace Cobra {
 		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 	}
 
-	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount)
+	void OpenGLRendererAPI::DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t vertexOffset)
 	{
 		vertexArray->Bind();
 		uint32_t count = indexCount ? indexCount : vertexArray->GetIndexBuffer()->GetCount();
-		glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr);
+		glDrawElementsBaseVertex(GL_TRIANGLES, count, GL_UNSIGNED_INT, nullptr, vertexOffset);
 	}
 
-	void OpenGLRendererAPI::DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount)
+	void OpenGLRendererAPI::DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t instanceOffset)
 	{
 		vertexArray->Bind();
-		glDrawArrays(GL_LINES, 0, vertexCount);
+		glDrawElementsInstancedBaseInstance(GL_TRIANGLES, indexCount, GL_UNSIGNED_INT, nullptr, instanceCount, instanceOffset);
+	}
+
+	RendererAPI::StateStatistics OpenGLRendererAPI::GetStateStatistics() const
+	{
+		return OpenGLStateCache::GetStatistics();
 	}
 
-	void OpenGLRendererAPI::SetLineWidth(float width)
+	void OpenGLRendererAPI::ResetStateStatistics()
 	{
-		glLineWidth(width);
+		OpenGLStateCache::ResetStatistics();
 	}
 
 }
\ No newline at end of file
@@ -9,14 +9,16 @@ namespace Cobra {
 	public:
 		void Init() override;
 		void SetViewport(uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		void GetViewport(uint32_t& x, uint32_t& y, uint32_t& width, uint32_t& height) const override;
 
 		void SetClearColor(const glm::vec4& color) override;
 		void Clear() const override;
 
-		void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0) override;
-		void DrawLines(const Ref<VertexArray>& vertexArray, uint32_t vertexCount) override;
+		void DrawIndexed(const Ref<VertexArray>& vertexArray, uint32_t indexCount = 0, uint32_t vertexOffset = 0) override;
+		void DrawIndexedInstanced(const Ref<VertexArray>& vertexArray, uint32_t indexCount, uint32_t instanceCount, uint32_t instanceOffset = 0) override;
 
-		void SetLineWidth(float width) override;
+		StateStatistics GetStateStatistics() const override;
+		void ResetStateStatistics() override;
 	};
 
 }
\ No newline at end of file
@@ -9,7 +9,11 @@
 #include <spirv_cross/spirv_cross.hpp>
 #include <spirv_cross/spirv_glsl.hpp>
 
+#include "Cobra/Core/Application.h"
+#include "Cobra/Core/Hash.h"
 #include "Cobra/Core/Timer.h"
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
 
 namespace Cobra {
 
@@ -48,6 +52,26 @@ namespace Cobra {
 			return nullptr;
 		}
 
+		static ShaderUniformType GLUniformTypeToShaderUniformType(GLenum type)
+		{
+			switch (type)
+			{
+				case GL_BOOL:
+				case GL_INT:        return ShaderUniformType::Int;
+				case GL_FLOAT:      return ShaderUniformType::Float;
+				case GL_FLOAT_VEC2: return ShaderUniformType::Float2;
+				case GL_FLOAT_VEC3: return ShaderUniformType::Float3;
+				case GL_FLOAT_VEC4: return ShaderUniformType::Float4;
+				case GL_FLOAT_MAT3: return ShaderUniformType::Mat3;
+				case GL_FLOAT_MAT4: return ShaderUniformType::Mat4;
+				case GL_SAMPLER_2D:
+				case GL_INT_SAMPLER_2D:
+				case GL_UNSIGNED_INT_SAMPLER_2D: return ShaderUniformType::Sampler;
+			}
+
+			return ShaderUniformType::None;
+		}
+
 		static const char* GetCacheDirectory()
 		{
 			// TODO: make sure the assets directory is valid
@@ -73,6 +97,11 @@ namespace Cobra {
 			return "";
 		}
 
+		static const char* GetProgramBinaryFileExtension()
+		{
+			return ".cached_opengl.program";
+		}
+
 		static const char* GLShaderStageCachedVulkanFileExtension(uint32_t stage)
 		{
 			switch (stage)
@@ -87,24 +116,24 @@ namespace Cobra {
 
 	}
 
-	OpenGLShader::OpenGLShader(const std::string& filepath)
-		: m_FilePath(filepath)
+	OpenGLShader::OpenGLShader(const std::string& filepath, const std::vector<std::string>& defines)
+		: OpenGLShader(DeferCompilation(), filepath, defines)
 	{
 		CB_PROFILE_FUNCTION();
 
 		Utils::CreateCacheDirectoryIfNeeded();
 
-		std::string source = ReadFile(filepath);
-		auto shaderSources = PreProcess(source);
-
-		{
-			Timer timer;
-			CompileOrGetVulkanBinaries(shaderSources);
-			CompileOrGetOpenGLBinaries();
-			CreateProgram();
-			CB_CORE_WARN("Shader creation took {0} ms", timer.ElapsedMillis());
-		}
+		Timer timer;
+		LoadSources();
+		for (GLenum stage : BeginCompilation())
+			CompileStage(stage);
+		Link();
+		CB_CORE_WARN("Shader creation took {0} ms", timer.ElapsedMillis());
+	}
 
+	OpenGLShader::OpenGLShader(DeferCompilation, const std::string& filepath, const std::vector<std::string>& defines)
+		: m_FilePath(filepath), m_Defines(defines)
+	{
 		// Extract name from filepath
 		auto lastSlash = filepath.find_last_of("/\\");
 		lastSlash = lastSlash == std::string::npos ? 0 : lastSlash + 1;
@@ -120,19 +149,58 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		std::unordered_map<GLenum, std::string> sources;
-		sources[GL_VERTEX_SHADER] = vertexSource;
-		sources[GL_FRAGMENT_SHADER] = fragmentSource;
+		Utils::CreateCacheDirectoryIfNeeded();
+
+		m_Sources[GL_VERTEX_SHADER] = vertexSource;
+		m_Sources[GL_FRAGMENT_SHADER] = fragmentSource;
+		HashSources();
 
-		CompileOrGetVulkanBinaries(sources);
-		CompileOrGetOpenGLBinaries();
-		CreateProgram();
+		for (GLenum stage : BeginCompilation())
+			CompileStage(stage);
+		Link();
+	}
+
+	std::vector<Ref<Shader>> OpenGLShader::CreateParallel(const std::vector<ShaderVariant>& variants)
+	{
+		CB_PROFILE_FUNCTION();
+
+		Utils::CreateCacheDirectoryIfNeeded();
+
+		Timer timer;
+
+		std::vector<Ref<OpenGLShader>> shaders;
+		for (const ShaderVariant& variant : variants)
+			shaders.push_back(RenderThread::CreateResource<OpenGLShader>(DeferCompilation(), variant.Filepath, variant.Defines));
+
+		ThreadPool& threadPool = Application::Get().GetThreadPool();
+		threadPool.ParallelFor((uint32_t)shaders.size(), [&](uint32_t index) { shaders[index]->LoadSources(); });
+
+		// Every stage of every shader is a separate job, so a single large shader does not serialize the rest
+		std::vector<std::pair<OpenGLShader*, GLenum>> stages;
+		for (auto& shader : shaders)
+		{
+			for (GLenum stage : shader->BeginCompilation())
+				stages.push_back({ shader.get(), stage });
+		}
+
+		threadPool.ParallelFor((uint32_t)stages.size(), [&](uint32_t index) { stages[index].first->CompileStage(stages[index].second); });
+
+		// Only linking needs the context, the render thread keeps drawing while the stages compile
+		RenderThread::Execute([&]()
+		{
+			for (auto& shader : shaders)
+				shader->Link();
+		});
+
+		CB_CORE_WARN("Creating {0} shaders took {1} ms", shaders.size(), timer.ElapsedMillis());
+		return std::vector<Ref<Shader>>(shaders.begin(), shaders.end());
 	}
 
 	OpenGLShader::~OpenGLShader()
 	{
 		CB_PROFILE_FUNCTION();
 
+		OpenGLStateCache::OnProgramDeleted(m_RendererID);
 		glDeleteProgram(m_RendererID);
 	}
 
@@ -140,14 +208,14 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		glUseProgram(m_RendererID);
+		RenderThread::Submit([this]() { OpenGLStateCache::UseProgram(m_RendererID); });
 	}
 
 	void OpenGLShader::Unbind() const
 	{
 		CB_PROFILE_FUNCTION();
 
-		glUseProgram(0);
+		RenderThread::Submit([]() { OpenGLStateCache::UseProgram(0); });
 	}
 
 	void OpenGLShader::SetInt(const std::string& name, int value)
@@ -199,52 +267,100 @@ namespace Cobra {
 		UploadUniformMat4(name, value);
 	}
 
+	ShaderUniformHandle OpenGLShader::GetUniform(const std::string& name) const
+	{
+		auto it = m_Reflection.Uniforms.find(name);
+		return it != m_Reflection.Uniforms.end() ? it->second : ShaderUniformHandle();
+	}
+
+	void OpenGLShader::SetInt(ShaderUniformHandle uniform, int value)
+	{
+		CB_CORE_ASSERT(!uniform.IsValid() || uniform.Type == ShaderUniformType::Int || uniform.Type == ShaderUniformType::Sampler);
+		RenderThread::Submit([location = uniform.Location, value]() { glUniform1i(location, value); });
+	}
+
+	void OpenGLShader::SetIntArray(ShaderUniformHandle uniform, int* values, uint32_t count)
+	{
+		CB_CORE_ASSERT(!uniform.IsValid() || ((uniform.Type == ShaderUniformType::Int || uniform.Type == ShaderUniformType::Sampler) && count <= uniform.Count));
+		RenderThread::Submit(Buffer(values, count * sizeof(int)), [location = uniform.Location, count](Buffer data) { glUniform1iv(location, count, data.As<int>()); });
+	}
+
+	void OpenGLShader::SetFloat(ShaderUniformHandle uniform, float value)
+	{
+		CB_CORE_ASSERT(!uniform.IsValid() || uniform.Type == ShaderUniformType::Float);
+		RenderThread::Submit([location = uniform.Location, value]() { glUniform1f(location, value); });
+	}
+
+	void OpenGLShader::SetFloat2(ShaderUniformHandle uniform, const glm::vec2& value)
+	{
+		CB_CORE_ASSERT(!uniform.IsValid() || uniform.Type == ShaderUniformType::Float2);
+		RenderThread::Submit([location = uniform.Location, value]() { glUniform2f(location, value.x, value.y); });
+	}
+
+	void OpenGLShader::SetFloat3(ShaderUniformHandle uniform, const glm::vec3& value)
+	{
+		CB_CORE_ASSERT(!uniform.IsValid() || uniform.Type == ShaderUniformType::Float3);
+		RenderThread::Submit([location = uniform.Location, value]() { glUniform3f(location, value.x, value.y, value.z); });
+	}
+
+	void OpenGLShader::SetFloat4(ShaderUniformHandle uniform, const glm::vec4& value)
+	{
+		CB_CORE_ASSERT(!uniform.IsValid() || uniform.Type == ShaderUniformType::Float4);
+		RenderThread::Submit([location = uniform.Location, value]() { glUniform4f(location, value.x, value.y, value.z, value.w); });
+	}
+
+	void OpenGLShader::SetMat4(ShaderUniformHandle uniform, const glm::mat4& value)
+	{
+		CB_CORE_ASSERT(!uniform.IsValid() || uniform.Type == ShaderUniformType::Mat4);
+		RenderThread::Submit([location = uniform.Location, value]() { glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(value)); });
+	}
+
 	void OpenGLShader::UploadUniformInt(const std::string& name, int value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1i(location, value);
+		GLint location = GetUniform(name).Location;
+		RenderThread::Submit([location, value]() { glUniform1i(location, value); });
 	}
 
 	void OpenGLShader::UploadUniformIntArray(const std::string& name, int* values, uint32_t count)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1iv(location, count, values);
+		GLint location = GetUniform(name).Location;
+		RenderThread::Submit(Buffer(values, count * sizeof(int)), [location, count](Buffer data) { glUniform1iv(location, count, data.As<int>()); });
 	}
 
 	void OpenGLShader::UploadUniformFloat(const std::string& name, float value)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform1f(location, value);
+		GLint location = GetUniform(name).Location;
+		RenderThread::Submit([location, value]() { glUniform1f(location, value); });
 	}
 
 	void OpenGLShader::UploadUniformFloat2(const std::string& name, const glm::vec2& values)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform2f(location, values.x, values.y);
+		GLint location = GetUniform(name).Location;
+		RenderThread::Submit([location, values]() { glUniform2f(location, values.x, values.y); });
 	}
 
 	void OpenGLShader::UploadUniformFloat3(const std::string& name, const glm::vec3& values)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform3f(location, values.x, values.y, values.z);
+		GLint location = GetUniform(name).Location;
+		RenderThread::Submit([location, values]() { glUniform3f(location, values.x, values.y, values.z); });
 	}
 
 	void OpenGLShader::UploadUniformFloat4(const std::string& name, const glm::vec4& values)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniform4f(location, values.x, values.y, values.z, values.w);
+		GLint location = GetUniform(name).Location;
+		RenderThread::Submit([location, values]() { glUniform4f(location, values.x, values.y, values.z, values.w); });
 	}
 
 	void OpenGLShader::UploadUniformMat3(const std::string& name, const glm::mat3& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+		GLint location = GetUniform(name).Location;
+		RenderThread::Submit([location, matrix]() { glUniformMatrix3fv(location, 1, GL_FALSE, glm::value_ptr(matrix)); });
 	}
 
 	void OpenGLShader::UploadUniformMat4(const std::string& name, const glm::mat4& matrix)
 	{
-		GLint location = glGetUniformLocation(m_RendererID, name.c_str());
-		glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix));
+		GLint location = GetUniform(name).Location;
+		RenderThread::Submit([location, matrix]() { glUniformMatrix4fv(location, 1, GL_FALSE, glm::value_ptr(matrix)); });
 	}
 
 	std::string OpenGLShader::ReadFile(const std::string& filepath)
@@ -310,9 +426,168 @@ namespace Cobra {
 		return shaderSources;
 	}
 
-	void OpenGLShader::CompileOrGetVulkanBinaries(const std::unordered_map<GLenum, std::string>& shaderSources)
+	void OpenGLShader::LoadSources()
+	{
+		CB_PROFILE_FUNCTION();
+
+		m_Sources = PreProcess(ReadFile(m_FilePath));
+		HashSources();
+	}
+
+	void OpenGLShader::HashSources()
+	{
+		// Bump when the compile options below change, old cache entries are then never looked up again
+		static const uint32_t cacheVersion = 1;
+
+		uint32_t spirvVersion, spirvRevision;
+		shaderc_get_spv_version(&spirvVersion, &spirvRevision);
+
+		uint64_t hash = Hash::FNV(&cacheVersion, sizeof(cacheVersion));
+		hash = Hash::FNV(&spirvVersion, sizeof(spirvVersion), hash);
+		hash = Hash::FNV(&spirvRevision, sizeof(spirvRevision), hash);
+
+		// Ordered by stage, the map's iteration order is not stable
+		for (GLenum stage : { GL_VERTEX_SHADER, GL_FRAGMENT_SHADER })
+		{
+			auto it = m_Sources.find(stage);
+			if (it == m_Sources.end())
+				continue;
+
+			hash = Hash::FNV(&stage, sizeof(stage), hash);
+			hash = Hash::FNV(it->second, hash);
+		}
+
+		for (const std::string& define : m_Defines)
+			hash = Hash::FNV(define + ";", hash);
+
+		m_SourceHash = hash;
+	}
+
+	std::string OpenGLShader::GetCacheFileName() const
+	{
+		// The name only keeps the cache directory readable, entries are told apart by the hash
+		return fmt::format("{}.{:016x}", m_Name, m_SourceHash);
+	}
+
+	std::vector<GLenum> OpenGLShader::BeginCompilation()
+	{
+		if (ReadProgramBinary())
+			return {};
+
+		return PrepareStages();
+	}
+
+	bool OpenGLShader::ReadProgramBinary()
 	{
+		CB_PROFILE_FUNCTION();
+
+		std::filesystem::path cachedPath = std::filesystem::path(Utils::GetCacheDirectory()) / (GetCacheFileName() + Utils::GetProgramBinaryFileExtension());
+
+		std::ifstream in(cachedPath, std::ios::in | std::ios::binary);
+		if (!in.is_open())
+			return false;
+
+		in.seekg(0, std::ios::end);
+		auto size = (size_t)in.tellg();
+		in.seekg(0, std::ios::beg);
+		if (size <= sizeof(GLenum))
+			return false;
+
+		m_ProgramBinary.resize(size - sizeof(GLenum));
+		in.read((char*)&m_ProgramBinaryFormat, sizeof(GLenum));
+		in.read(m_ProgramBinary.data(), m_ProgramBinary.size());
+		return true;
+	}
+
+	std::vector<GLenum> OpenGLShader::PrepareStages()
+	{
+		// Inserted up front so that stages compiled in parallel only write to existing entries
+		std::vector<GLenum> stages;
+		for (auto&& [stage, source] : m_Sources)
+		{
+			m_VulkanSPIRV[stage];
+			m_OpenGLSPIRV[stage];
+			m_OpenGLSourceCode[stage];
+			stages.push_back(stage);
+		}
+
+		return stages;
+	}
+
+	void OpenGLShader::CompileStage(GLenum stage)
+	{
+		CompileOrGetVulkanBinary(stage);
+		CompileOrGetOpenGLBinary(stage);
+	}
+
+	void OpenGLShader::Link()
+	{
+		CB_PROFILE_FUNCTION();
+
+		if (LoadProgramBinary())
+			return;
+
+		// The binary was rejected, so nothing has been compiled yet
+		if (m_OpenGLSPIRV.empty())
+		{
+			for (GLenum stage : PrepareStages())
+				CompileStage(stage);
+		}
+
+		CreateProgram();
+	}
+
+	bool OpenGLShader::LoadProgramBinary()
+	{
+		if (m_ProgramBinary.empty())
+			return false;
+
 		GLuint program = glCreateProgram();
+		glProgramBinary(program, m_ProgramBinaryFormat, m_ProgramBinary.data(), (GLsizei)m_ProgramBinary.size());
+		m_ProgramBinary.clear();
+
+		// Binaries are rejected after driver updates, the program is then rebuilt and the binary replaced
+		GLint isLinked;
+		glGetProgramiv(program, GL_LINK_STATUS, &isLinked);
+		if (isLinked == GL_FALSE)
+		{
+			glDeleteProgram(program);
+			return false;
+		}
+
+		m_RendererID = program;
+		ReflectProgram();
+		return true;
+	}
+
+	void OpenGLShader::SaveProgramBinary()
+	{
+		CB_PROFILE_FUNCTION();
+
+		GLint length = 0;
+		glGetProgramiv(m_RendererID, GL_PROGRAM_BINARY_LENGTH, &length);
+		if (length <= 0)
+			return;
+
+		GLenum format;
+		std::vector<char> binary(length);
+		glGetProgramBinary(m_RendererID, length, &length, &format, binary.data());
+
+		std::filesystem::path cachedPath = std::filesystem::path(Utils::GetCacheDirectory()) / (GetCacheFileName() + Utils::GetProgramBinaryFileExtension());
+
+		std::ofstream out(cachedPath, std::ios::out | std::ios::binary);
+		if (out.is_open())
+		{
+			out.write((char*)&format, sizeof(GLenum));
+			out.write(binary.data(), length);
+			out.flush();
+			out.close();
+		}
+	}
+
+	void OpenGLShader::CompileOrGetVulkanBinary(GLenum stage)
+	{
+		CB_PROFILE_FUNCTION();
 
 		shaderc::Compiler compiler;
 		shaderc::CompileOptions options;
@@ -321,55 +596,51 @@ namespace Cobra {
 		if (optimize)
 			options.SetOptimizationLevel(shaderc_optimization_level_performance);
 
+		for (const std::string& define : m_Defines)
+			options.AddMacroDefinition(define);
+
 		std::filesystem::path cacheDirectory = Utils::GetCacheDirectory();
+		std::filesystem::path cachedPath = cacheDirectory / (GetCacheFileName() + Utils::GLShaderStageCachedVulkanFileExtension(stage));
+
+		// Only ever accessed through at, stages of one shader may be compiled concurrently
+		auto& data = m_VulkanSPIRV.at(stage);
 
-		auto& shaderData = m_VulkanSPIRV;
-		shaderData.clear();
-		for (auto&& [stage, source] : shaderSources)
+		std::ifstream in(cachedPath, std::ios::in | std::ios::binary);
+		if (in.is_open())
 		{
-			std::filesystem::path shaderFilePath = m_FilePath;
-			std::filesystem::path cachedPath = cacheDirectory / (shaderFilePath.filename().string() + Utils::GLShaderStageCachedVulkanFileExtension(stage));
+			in.seekg(0, std::ios::end);
+			auto size = in.tellg();
+			in.seekg(0, std::ios::beg);
 
-			std::ifstream in(cachedPath, std::ios::in | std::ios::binary);
-			if (in.is_open())
+			data.resize(size / sizeof(uint32_t));
+			in.read((char*)data.data(), size);
+		}
+		else
+		{
+			shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(m_Sources.at(stage), Utils::GLShaderStageToShaderC(stage), m_FilePath.c_str(), options);
+			if (module.GetCompilationStatus() != shaderc_compilation_status_success)
 			{
-				in.seekg(0, std::ios::end);
-				auto size = in.tellg();
-				in.seekg(0, std::ios::beg);
-
-				auto& data = shaderData[stage];
-				data.resize(size / sizeof(uint32_t));
-				in.read((char*)data.data(), size);
+				CB_CORE_ERROR(module.GetErrorMessage());
+				CB_CORE_ASSERT(false);
 			}
-			else
+
+			data = std::vector<uint32_t>(module.cbegin(), module.cend());
+
+			std::ofstream out(cachedPath, std::ios::out | std::ios::binary);
+			if (out.is_open())
 			{
-				shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, Utils::GLShaderStageToShaderC(stage), m_FilePath.c_str(), options);
-				if (module.GetCompilationStatus() != shaderc_compilation_status_success)
-				{
-					CB_CORE_ERROR(module.GetErrorMessage());
-					CB_CORE_ASSERT(false);
-				}
-
-				shaderData[stage] = std::vector<uint32_t>(module.cbegin(), module.cend());
-
-				std::ofstream out(cachedPath, std::ios::out | std::ios::binary);
-				if (out.is_open())
-				{
-					auto& data = shaderData[stage];
-					out.write((char*)data.data(), data.size() * sizeof(uint32_t));
-					out.flush();
-					out.close();
-				}
+				out.write((char*)data.data(), data.size() * sizeof(uint32_t));
+				out.flush();
+				out.close();
 			}
 		}
 
-		for (auto&& [stage, data] : shaderData)
-			Reflect(stage, data);
+		Reflect(stage, data);
 	}
 
-	void OpenGLShader::CompileOrGetOpenGLBinaries()
+	void OpenGLShader::CompileOrGetOpenGLBinary(GLenum stage)
 	{
-		auto& shaderData = m_OpenGLSPIRV;
+		CB_PROFILE_FUNCTION();
 
 		shaderc::Compiler compiler;
 		shaderc::CompileOptions options;
@@ -379,48 +650,41 @@ namespace Cobra {
 			options.SetOptimizationLevel(shaderc_optimization_level_performance);
 
 		std::filesystem::path cacheDirectory = Utils::GetCacheDirectory();
+		std::filesystem::path cachedPath = cacheDirectory / (GetCacheFileName() + Utils::GLShaderStageCachedOpenGLFileExtension(stage));
+
+		auto& data = m_OpenGLSPIRV.at(stage);
 
-		shaderData.clear();
-		m_OpenGLSourceCode.clear();
-		for (auto&& [stage, spirv] : m_VulkanSPIRV)
+		std::ifstream in(cachedPath, std::ios::in | std::ios::binary);
+		if (in.is_open())
 		{
-			std::filesystem::path shaderFilePath = m_FilePath;
-			std::filesystem::path cachedPath = cacheDirectory / (shaderFilePath.filename().string() + Utils::GLShaderStageCachedOpenGLFileExtension(stage));
+			in.seekg(0, std::ios::end);
+			auto size = in.tellg();
+			in.seekg(0, std::ios::beg);
 
-			std::ifstream in(cachedPath, std::ios::in | std::ios::binary);
-			if (in.is_open())
-			{
-				in.seekg(0, std::ios::end);
-				auto size = in.tellg();
-				in.seekg(0, std::ios::beg);
+			data.resize(size / sizeof(uint32_t));
+			in.read((char*)data.data(), size);
+		}
+		else
+		{
+			spirv_cross::CompilerGLSL glslCompiler(m_VulkanSPIRV.at(stage));
+			auto& source = m_OpenGLSourceCode.at(stage);
+			source = glslCompiler.compile();
 
-				auto& data = shaderData[stage];
-				data.resize(size / sizeof(uint32_t));
-				in.read((char*)data.data(), size);
+			shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, Utils::GLShaderStageToShaderC(stage), m_FilePath.c_str());
+			if (module.GetCompilationStatus() != shaderc_compilation_status_success)
+			{
+				CB_CORE_ERROR(module.GetErrorMessage());
+				CB_CORE_ASSERT(false);
 			}
-			else
+
+			data = std::vector<uint32_t>(module.cbegin(), module.cend());
+
+			std::ofstream out(cachedPath, std::ios::out | std::ios::binary);
+			if (out.is_open())
 			{
-				spirv_cross::CompilerGLSL glslCompiler(spirv);
-				m_OpenGLSourceCode[stage] = glslCompiler.compile();
-				auto& source = m_OpenGLSourceCode[stage];
-
-				shaderc::SpvCompilationResult module = compiler.CompileGlslToSpv(source, Utils::GLShaderStageToShaderC(stage), m_FilePath.c_str());
-				if (module.GetCompilationStatus() != shaderc_compilation_status_success)
-				{
-					CB_CORE_ERROR(module.GetErrorMessage());
-					CB_CORE_ASSERT(false);
-				}
-
-				shaderData[stage] = std::vector<uint32_t>(module.cbegin(), module.cend());
-
-				std::ofstream out(cachedPath, std::ios::out | std::ios::binary);
-				if (out.is_open())
-				{
-					auto& data = shaderData[stage];
-					out.write((char*)data.data(), data.size() * sizeof(uint32_t));
-					out.flush();
-					out.close();
-				}
+				out.write((char*)data.data(), data.size() * sizeof(uint32_t));
+				out.flush();
+				out.close();
 			}
 		}
 	}
@@ -438,6 +702,7 @@ namespace Cobra {
 			glAttachShader(program, shaderID);
 		}
 
+		glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
 		glLinkProgram(program);
 
 		GLint isLinked;
@@ -464,6 +729,12 @@ namespace Cobra {
 		}
 
 		m_RendererID = program;
+
+		if (isLinked == GL_TRUE)
+		{
+			SaveProgramBinary();
+			ReflectProgram();
+		}
 	}
 
 	void OpenGLShader::Reflect(GLenum stage, const std::vector<uint32_t>& shaderData)
@@ -490,4 +761,57 @@ namespace Cobra {
 		}
 	}
 
-}
\ No newline at end of file
+	void OpenGLShader::ReflectProgram()
+	{
+		// Programs loaded from a binary have no SPIR-V to reflect, so everything is queried from the linked program
+		m_Reflection = {};
+
+		GLint blockCount = 0;
+		glGetProgramInterfaceiv(m_RendererID, GL_UNIFORM_BLOCK, GL_ACTIVE_RESOURCES, &blockCount);
+
+		const GLenum blockProperties[] = { GL_BUFFER_BINDING, GL_BUFFER_DATA_SIZE, GL_NUM_ACTIVE_VARIABLES, GL_NAME_LENGTH };
+		for (GLint i = 0; i < blockCount; i++)
+		{
+			GLint values[4];
+			glGetProgramResourceiv(m_RendererID, GL_UNIFORM_BLOCK, i, 4, blockProperties, 4, nullptr, values);
+
+			std::string name(std::max(values[3], 1), '\0');
+			glGetProgramResourceName(m_RendererID, GL_UNIFORM_BLOCK, i, (GLsizei)name.size(), nullptr, name.data());
+			name.pop_back(); // Null terminator
+
+			m_Reflection.UniformBuffers.push_back({ name, (uint32_t)values[0], (uint32_t)values[1], (uint32_t)values[2] });
+		}
+
+		GLint uniformCount = 0;
+		glGetProgramInterfaceiv(m_RendererID, GL_UNIFORM, GL_ACTIVE_RESOURCES, &uniformCount);
+
+		const GLenum properties[] = { GL_BLOCK_INDEX, GL_TYPE, GL_ARRAY_SIZE, GL_LOCATION, GL_NAME_LENGTH };
+		for (GLint i = 0; i < uniformCount; i++)
+		{
+			GLint values[5];
+			glGetProgramResourceiv(m_RendererID, GL_UNIFORM, i, 5, properties, 5, nullptr, values);
+
+			// Members of uniform buffers have no location
+			if (values[0] != -1 || values[3] == -1 || values[4] <= 1)
+				continue;
+
+			std::string name(values[4], '\0');
+			glGetProgramResourceName(m_RendererID, GL_UNIFORM, i, values[4], nullptr, name.data());
+			name.pop_back(); // Null terminator
+
+			if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0)
+				name.resize(name.size() - 3);
+
+			ShaderUniformHandle uniform = { values[3], Utils::GLUniformTypeToShaderUniformType(values[1]), (uint32_t)values[2] };
+			m_Reflection.Uniforms[name] = uniform;
+
+			if (uniform.Type == ShaderUniformType::Sampler)
+			{
+				GLint binding;
+				glGetUniformiv(m_RendererID, uniform.Location, &binding);
+				m_Reflection.Samplers.push_back({ name, (uint32_t)binding, uniform.Count });
+			}
+		}
+	}
+
+}
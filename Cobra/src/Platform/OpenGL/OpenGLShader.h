@@ -15,13 +15,25 @@ namespace Cobra {
 		uint32_t m_RendererID;
 		std::string m_FilePath;
 		std::string m_Name;
+		std::vector<std::string> m_Defines;
+		uint64_t m_SourceHash = 0; // Covers the sources, defines and compiler version
 
+		std::unordered_map<GLenum, std::string> m_Sources;
 		std::unordered_map<GLenum, std::vector<uint32_t>> m_VulkanSPIRV;
 		std::unordered_map<GLenum, std::vector<uint32_t>> m_OpenGLSPIRV;
 
 		std::unordered_map<GLenum, std::string> m_OpenGLSourceCode;
+
+		std::vector<char> m_ProgramBinary; // Read from the cache, consumed by Link
+		GLenum m_ProgramBinaryFormat = 0;
+
+		ShaderReflection m_Reflection;
+
+		struct DeferCompilation { };
 	public:
-		OpenGLShader(const std::string& filepath);
+		OpenGLShader(const std::string& filepath, const std::vector<std::string>& defines = {});
+		// Only sets up the name, used by CreateParallel
+		OpenGLShader(DeferCompilation, const std::string& filepath, const std::vector<std::string>& defines);
 		OpenGLShader(const std::string& name, const std::string& vertexSource, const std::string& fragmentSource);
 		virtual ~OpenGLShader();
 
@@ -36,8 +48,22 @@ namespace Cobra {
 		void SetFloat4(const std::string& name, const glm::vec4& value) override;
 		void SetMat4(const std::string& name, const glm::mat4& value) override;
 
+		ShaderUniformHandle GetUniform(const std::string& name) const override;
+
+		void SetInt(ShaderUniformHandle uniform, int value) override;
+		void SetIntArray(ShaderUniformHandle uniform, int* values, uint32_t count) override;
+		void SetFloat(ShaderUniformHandle uniform, float value) override;
+		void SetFloat2(ShaderUniformHandle uniform, const glm::vec2& value) override;
+		void SetFloat3(ShaderUniformHandle uniform, const glm::vec3& value) override;
+		void SetFloat4(ShaderUniformHandle uniform, const glm::vec4& value) override;
+		void SetMat4(ShaderUniformHandle uniform, const glm::mat4& value) override;
+
+		const ShaderReflection& GetReflection() const override { return m_Reflection; }
 		const std::string& GetName() const override { return m_Name; }
 
+		// Loads, preprocesses and compiles the stages of every shader on the thread pool, only program creation runs on the calling thread
+		static std::vector<Ref<Shader>> CreateParallel(const std::vector<ShaderVariant>& variants);
+
 		void UploadUniformInt(const std::string& name, int value);
 		void UploadUniformIntArray(const std::string& name, int* values, uint32_t count);
 
@@ -51,11 +77,24 @@ namespace Cobra {
 	private:
 		std::string ReadFile(const std::string& filepath);
 		std::unordered_map<GLenum, std::string> PreProcess(const std::string& source);
-		
-		void CompileOrGetVulkanBinaries(const std::unordered_map<GLenum, std::string>& shaderSources);
-		void CompileOrGetOpenGLBinaries();
+		void LoadSources();
+		void HashSources();
+		std::string GetCacheFileName() const;
+
+		// Everything up to Link only touches the shader itself and may run on any thread
+		std::vector<GLenum> BeginCompilation(); // Returns the stages to compile, none if a program binary is cached
+		bool ReadProgramBinary();
+		std::vector<GLenum> PrepareStages();
+		void CompileStage(GLenum stage);
+		void CompileOrGetVulkanBinary(GLenum stage);
+		void CompileOrGetOpenGLBinary(GLenum stage);
+
+		void Link();
+		bool LoadProgramBinary();
+		void SaveProgramBinary();
 		void CreateProgram();
 		void Reflect(GLenum stage, const std::vector<uint32_t>& shaderData);
+		void ReflectProgram();
 	};
 
 }
\ No newline at end of file
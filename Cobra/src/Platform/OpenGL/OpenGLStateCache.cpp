@@ -0,0 +1,212 @@
+#include "cbpch.h"
+#include "OpenGLStateCache.h"
+
+#include <glad/glad.h>
+
+namespace Cobra {
+
+	static const uint32_t s_Unknown = 0xFFFFFFFF;
+
+	struct OpenGLStateData
+	{
+		static const uint32_t MaxTextureUnits = 32;
+		static const uint32_t MaxUniformBufferBindings = 16;
+
+		uint32_t Program = s_Unknown;
+		uint32_t VertexArray = s_Unknown;
+
+		// Array, element array, pixel pack and pixel unpack buffers
+		std::array<uint32_t, 4> Buffers;
+		std::array<uint32_t, MaxUniformBufferBindings> UniformBuffers;
+		std::array<uint32_t, MaxTextureUnits> TextureUnits;
+
+		int32_t Blend = -1;
+		uint32_t BlendSourceFactor = s_Unknown;
+		uint32_t BlendDestinationFactor = s_Unknown;
+
+		RendererAPI::StateStatistics Stats;
+
+		OpenGLStateData()
+		{
+			Buffers.fill(s_Unknown);
+			UniformBuffers.fill(s_Unknown);
+			TextureUnits.fill(s_Unknown);
+		}
+	};
+
+	static OpenGLStateData s_State;
+
+	namespace Utils {
+
+		static int GetBufferSlot(uint32_t target)
+		{
+			switch (target)
+			{
+				case GL_ARRAY_BUFFER:         return 0;
+				case GL_ELEMENT_ARRAY_BUFFER: return 1;
+				case GL_PIXCB_PACK_BUFFER:    return 2; // GL_PIXEL_PACK_BUFFER, as named by our glad
+				case GL_PIXCB_UNPACK_BUFFER:  return 3;
+			}
+
+			return -1;
+		}
+
+		// Returns true if the call has to be issued, and records the new value
+		template<typename T>
+		static bool Update(T& cached, T value)
+		{
+			if (cached == value)
+			{
+				s_State.Stats.Elided++;
+				return false;
+			}
+
+			cached = value;
+			s_State.Stats.Issued++;
+			return true;
+		}
+
+	}
+
+	void OpenGLStateCache::UseProgram(uint32_t program)
+	{
+		if (Utils::Update(s_State.Program, program))
+			glUseProgram(program);
+	}
+
+	void OpenGLStateCache::BindVertexArray(uint32_t vertexArray)
+	{
+		if (Utils::Update(s_State.VertexArray, vertexArray))
+		{
+			glBindVertexArray(vertexArray);
+
+			// The element array binding is part of the vertex array
+			s_State.Buffers[Utils::GetBufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = s_Unknown;
+		}
+	}
+
+	void OpenGLStateCache::BindBuffer(uint32_t target, uint32_t buffer)
+	{
+		int slot = Utils::GetBufferSlot(target);
+		if (slot == -1)
+		{
+			s_State.Stats.Issued++;
+			glBindBuffer(target, buffer);
+			return;
+		}
+
+		if (Utils::Update(s_State.Buffers[slot], buffer))
+			glBindBuffer(target, buffer);
+	}
+
+	void OpenGLStateCache::BindUniformBuffer(uint32_t binding, uint32_t buffer)
+	{
+		if (binding >= OpenGLStateData::MaxUniformBufferBindings)
+		{
+			s_State.Stats.Issued++;
+			glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+			return;
+		}
+
+		if (Utils::Update(s_State.UniformBuffers[binding], buffer))
+			glBindBufferBase(GL_UNIFORM_BUFFER, binding, buffer);
+	}
+
+	void OpenGLStateCache::BindTextureUnit(uint32_t unit, uint32_t texture)
+	{
+		if (unit >= OpenGLStateData::MaxTextureUnits)
+		{
+			s_State.Stats.Issued++;
+			glBindTextureUnit(unit, texture);
+			return;
+		}
+
+		if (Utils::Update(s_State.TextureUnits[unit], texture))
+			glBindTextureUnit(unit, texture);
+	}
+
+	void OpenGLStateCache::SetBlend(bool enabled)
+	{
+		if (Utils::Update(s_State.Blend, (int32_t)enabled))
+		{
+			if (enabled)
+				glEnable(GL_BLEND);
+			else
+				glDisable(GL_BLEND);
+		}
+	}
+
+	void OpenGLStateCache::SetBlendFunc(uint32_t sourceFactor, uint32_t destinationFactor)
+	{
+		if (s_State.BlendSourceFactor == sourceFactor && s_State.BlendDestinationFactor == destinationFactor)
+		{
+			s_State.Stats.Elided++;
+			return;
+		}
+
+		s_State.BlendSourceFactor = sourceFactor;
+		s_State.BlendDestinationFactor = destinationFactor;
+		s_State.Stats.Issued++;
+		glBlendFunc(sourceFactor, destinationFactor);
+	}
+
+	void OpenGLStateCache::OnProgramDeleted(uint32_t program)
+	{
+		if (s_State.Program == program)
+			s_State.Program = s_Unknown;
+	}
+
+	void OpenGLStateCache::OnVertexArrayDeleted(uint32_t vertexArray)
+	{
+		if (s_State.VertexArray == vertexArray)
+		{
+			s_State.VertexArray = s_Unknown;
+			s_State.Buffers[Utils::GetBufferSlot(GL_ELEMENT_ARRAY_BUFFER)] = s_Unknown;
+		}
+	}
+
+	void OpenGLStateCache::OnBufferDeleted(uint32_t buffer)
+	{
+		for (uint32_t& bound : s_State.Buffers)
+		{
+			if (bound == buffer)
+				bound = s_Unknown;
+		}
+
+		for (uint32_t& bound : s_State.UniformBuffers)
+		{
+			if (bound == buffer)
+				bound = s_Unknown;
+		}
+	}
+
+	void OpenGLStateCache::OnTexturesDeleted(uint32_t count, const uint32_t* textures)
+	{
+		for (uint32_t i = 0; i < count; i++)
+		{
+			for (uint32_t& bound : s_State.TextureUnits)
+			{
+				if (bound == textures[i])
+					bound = s_Unknown;
+			}
+		}
+	}
+
+	void OpenGLStateCache::Invalidate()
+	{
+		RendererAPI::StateStatistics stats = s_State.Stats;
+		s_State = OpenGLStateData();
+		s_State.Stats = stats;
+	}
+
+	RendererAPI::StateStatistics OpenGLStateCache::GetStatistics()
+	{
+		return s_State.Stats;
+	}
+
+	void OpenGLStateCache::ResetStatistics()
+	{
+		s_State.Stats = {};
+	}
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Cobra/Renderer/RendererAPI.h"
+
+namespace Cobra {
+
+	// Mirrors the state set through it and drops calls that would not change anything. Every binding made
+	// by the OpenGL platform layer has to go through here, and deleted objects have to be reported, since
+	// their names get reused.
+	class OpenGLStateCache
+	{
+	public:
+		static void UseProgram(uint32_t program);
+		static void BindVertexArray(uint32_t vertexArray);
+		static void BindBuffer(uint32_t target, uint32_t buffer);
+		static void BindUniformBuffer(uint32_t binding, uint32_t buffer);
+		static void BindTextureUnit(uint32_t unit, uint32_t texture);
+
+		static void SetBlend(bool enabled);
+		static void SetBlendFunc(uint32_t sourceFactor, uint32_t destinationFactor);
+
+		static void OnProgramDeleted(uint32_t program);
+		static void OnVertexArrayDeleted(uint32_t vertexArray);
+		static void OnBufferDeleted(uint32_t buffer);
+		static void OnTexturesDeleted(uint32_t count, const uint32_t* textures);
+
+		// Forgets everything, for after code outside of the cache has touched the state
+		static void Invalidate();
+
+		static RendererAPI::StateStatistics GetStatistics();
+		static void ResetStatistics();
+	};
+
+}
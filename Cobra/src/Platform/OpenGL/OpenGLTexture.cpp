@@ -1,6 +1,18 @@
 #include "cbpch.h"
 #include "OpenGLTexture.h"
 
+#include "Cobra/Renderer/TextureCompressor.h"
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
+
+// Not part of core OpenGL, but supported by every desktop driver
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+	#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+	#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT 0x83F3
+#endif
+
 namespace Cobra {
 
 	namespace Utils {
@@ -11,6 +23,9 @@ namespace Cobra {
 			{
 				case ImageFormat::RGB8: return GL_RGB; break;
 				case ImageFormat::RGBA8: return GL_RGBA; break;
+				case ImageFormat::BC1: return GL_RGB; break;
+				case ImageFormat::BC3: return GL_RGBA; break;
+				case ImageFormat::BC7: return GL_RGBA; break;
 			}
 
 			CB_CORE_ASSERT(false);
@@ -23,6 +38,9 @@ namespace Cobra {
 			{
 				case ImageFormat::RGB8: return GL_RGB8; break;
 				case ImageFormat::RGBA8: return GL_RGBA8; break;
+				case ImageFormat::BC1: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT; break;
+				case ImageFormat::BC3: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+				case ImageFormat::BC7: return GL_COMPRESSED_RGBA_BPTC_UNORM; break;
 			}
 
 			CB_CORE_ASSERT(false);
@@ -39,10 +57,12 @@ namespace Cobra {
 		m_InternalFormat = Utils::CobraImageFormatToGLInternalFormat(m_Specification.Format);
 		m_DataFormat = Utils::CobraImageFormatToGLDataFormat(m_Specification.Format);
 
+		m_MipCount = m_Specification.GenerateMips ? TextureCompressor::GetMipCount(m_Width, m_Height) : 1;
+
 		glCreateTextures(GL_TEXTURE_2D, 1, &m_RendererID);
-		glTextureStorage2D(m_RendererID, 1, m_InternalFormat, m_Width, m_Height);
+		glTextureStorage2D(m_RendererID, m_MipCount, m_InternalFormat, m_Width, m_Height);
 
-		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTextureParameteri(m_RendererID, GL_TEXTURE_MIN_FILTER, m_MipCount > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
 		glTextureParameteri(m_RendererID, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
 		glTextureParameteri(m_RendererID, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -52,10 +72,23 @@ namespace Cobra {
 			SetData(data);
 	}
 
+	std::vector<OpenGLTexture2D::PendingUpload> OpenGLTexture2D::s_PendingUploads;
+
 	OpenGLTexture2D::~OpenGLTexture2D()
 	{
 		CB_PROFILE_FUNCTION();
 
+		for (auto it = s_PendingUploads.begin(); it != s_PendingUploads.end(); ++it)
+		{
+			if (it->Texture == this)
+			{
+				ReleaseUpload(*it);
+				s_PendingUploads.erase(it);
+				break;
+			}
+		}
+
+		OpenGLStateCache::OnTexturesDeleted(1, &m_RendererID);
 		glDeleteTextures(1, &m_RendererID);
 	}
 
@@ -63,17 +96,234 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		uint32_t bpp = m_DataFormat == GL_RGBA ? 4 : 3;
-		CB_CORE_ASSERT(data.Size == (m_Width * m_Height * bpp), "Data must be entire texture!");
+		RenderThread::Submit(data, [this](Buffer data)
+		{
+			m_IsLoaded = true;
+
+			// Compressed data already holds the mip chain, it can not be generated on the GPU
+			if (TextureCompressor::IsCompressed(m_Specification.Format))
+			{
+				CB_CORE_ASSERT(data.Size == TextureCompressor::GetChainSize(m_Specification.Format, m_Width, m_Height, m_MipCount), "Data must be entire mip chain!");
+
+				const uint8_t* levelData = data.Data;
+				for (uint32_t mip = 0; mip < m_MipCount; mip++)
+				{
+					uint32_t width = std::max(m_Width >> mip, 1u);
+					uint32_t height = std::max(m_Height >> mip, 1u);
+					GLsizei size = (GLsizei)TextureCompressor::GetLevelSize(m_Specification.Format, width, height);
+
+					glCompressedTextureSubImage2D(m_RendererID, mip, 0, 0, width, height, m_InternalFormat, size, levelData);
+					levelData += size;
+				}
+
+				return;
+			}
+
+			uint32_t bpp = m_DataFormat == GL_RGBA ? 4 : 3;
+			CB_CORE_ASSERT(data.Size == (m_Width * m_Height * bpp), "Data must be entire texture!");
+
+			glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, data.Data);
+			RegenerateMips();
+		});
+	}
+
+	void OpenGLTexture2D::SetDataAsync(Buffer data)
+	{
+		CB_PROFILE_FUNCTION();
+
+		uint32_t mipCount = TextureCompressor::IsCompressed(m_Specification.Format) ? m_MipCount : 1;
+		CB_CORE_ASSERT(data.Size == TextureCompressor::GetChainSize(m_Specification.Format, m_Width, m_Height, mipCount), "Data must be entire texture!");
+
+		// Kept until the upload finishes, UpdateAsyncUploads copies it into the buffer within the budget
+		Buffer staging = Buffer::Copy(data);
+		RenderThread::Submit([this, staging]()
+		{
+			CB_CORE_ASSERT(std::none_of(s_PendingUploads.begin(), s_PendingUploads.end(), [this](const PendingUpload& upload) { return upload.Texture == this; }), "Texture is already being uploaded!");
+
+			m_IsLoaded = false;
+
+			PendingUpload& upload = s_PendingUploads.emplace_back();
+			upload.Texture = this;
+			upload.Data = staging;
+
+			GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT;
+			glCreateBuffers(1, &upload.Buffer);
+			glNamedBufferStorage(upload.Buffer, staging.Size, nullptr, flags);
+			upload.Mapped = (uint8_t*)glMapNamedBufferRange(upload.Buffer, 0, staging.Size, flags | GL_MAP_FLUSH_EXPLICIT_BIT);
+		});
+	}
+
+	void OpenGLTexture2D::SetData(Buffer data, uint32_t x, uint32_t y, uint32_t width, uint32_t height)
+	{
+		CB_PROFILE_FUNCTION();
+
+		RenderThread::Submit(data, [this, x, y, width, height](Buffer data)
+		{
+			uint32_t bpp = m_DataFormat == GL_RGBA ? 4 : 3;
+			CB_CORE_ASSERT(!TextureCompressor::IsCompressed(m_Specification.Format), "Compressed textures can only be uploaded whole!");
+			CB_CORE_ASSERT(x + width <= m_Width && y + height <= m_Height, "Region must be inside the texture!");
+			CB_CORE_ASSERT(data.Size == (width * height * bpp), "Data must be entire region!");
+
+			// Rows of an RGB region are generally not 4 byte aligned
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+			glTextureSubImage2D(m_RendererID, 0, x, y, width, height, m_DataFormat, GL_UNSIGNED_BYTE, data.Data);
+			glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+			RegenerateMips();
+		});
+	}
+
+	void OpenGLTexture2D::Clear()
+	{
+		CB_PROFILE_FUNCTION();
+
+		CB_CORE_ASSERT(!TextureCompressor::IsCompressed(m_Specification.Format), "Compressed textures can not be cleared!");
+
+		RenderThread::Submit([this]()
+		{
+			m_IsLoaded = true;
+
+			// Without data the texels are set to zero
+			for (uint32_t mip = 0; mip < m_MipCount; mip++)
+				glClearTexImage(m_RendererID, mip, m_DataFormat, GL_UNSIGNED_BYTE, nullptr);
+		});
+	}
+
+	void OpenGLTexture2D::CopyFrom(const Texture& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height, uint32_t x, uint32_t y)
+	{
+		CB_PROFILE_FUNCTION();
+
+		CB_CORE_ASSERT(source.GetSpecification().Format == m_Specification.Format, "Textures must have the same format!");
+		CB_CORE_ASSERT(x + width <= m_Width && y + height <= m_Height, "Region must be inside the texture!");
+
+		// The source is released through a render command as well, so it is still alive when this one runs
+		RenderThread::Submit([this, source = &source, sourceX, sourceY, width, height, x, y]()
+		{
+			glCopyImageSubData(source->GetRendererID(), GL_TEXTURE_2D, 0, sourceX, sourceY, 0, m_RendererID, GL_TEXTURE_2D, 0, x, y, 0, width, height, 1);
+		});
+	}
+
+	void OpenGLTexture2D::RegenerateMips()
+	{
+		RenderThread::Submit([this]()
+		{
+			if (m_MipCount > 1 && !TextureCompressor::IsCompressed(m_Specification.Format))
+				glGenerateTextureMipmap(m_RendererID);
+		});
+	}
+
+	uint64_t OpenGLTexture2D::IssueUploadSteps(PendingUpload& upload, uint64_t budget, bool mustProgress)
+	{
+		uint64_t issued = 0;
+		OpenGLStateCache::BindBuffer(GL_PIXCB_UNPACK_BUFFER, upload.Buffer); // GL_PIXEL_UNPACK_BUFFER, as named by our glad
+
+		if (TextureCompressor::IsCompressed(m_Specification.Format))
+		{
+			uint64_t offset = TextureCompressor::GetChainSize(m_Specification.Format, m_Width, m_Height, upload.NextStep);
+			while (upload.NextStep < m_MipCount)
+			{
+				uint32_t width = std::max(m_Width >> upload.NextStep, 1u);
+				uint32_t height = std::max(m_Height >> upload.NextStep, 1u);
+				uint64_t size = TextureCompressor::GetLevelSize(m_Specification.Format, width, height);
+				if (issued + size > budget && !(mustProgress && issued == 0))
+					break;
+
+				StageUploadRange(upload, offset, size);
+				glCompressedTextureSubImage2D(m_RendererID, upload.NextStep, 0, 0, width, height, m_InternalFormat, (GLsizei)size, (const void*)offset);
+				offset += size;
+				issued += size;
+				upload.NextStep++;
+			}
+		}
+		else
+		{
+			uint64_t rowSize = TextureCompressor::GetLevelSize(m_Specification.Format, m_Width, 1);
+			uint32_t rows = (uint32_t)std::min<uint64_t>(budget / rowSize, m_Height - upload.NextStep);
+			if (rows == 0 && mustProgress)
+				rows = 1;
+
+			if (rows > 0)
+			{
+				StageUploadRange(upload, upload.NextStep * rowSize, rows * rowSize);
+
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+				glTextureSubImage2D(m_RendererID, 0, 0, upload.NextStep, m_Width, rows, m_DataFormat, GL_UNSIGNED_BYTE, (const void*)(upload.NextStep * rowSize));
+				glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+				issued = rows * rowSize;
+				upload.NextStep += rows;
+			}
+
+			if (upload.NextStep == m_Height)
+				RegenerateMips();
+		}
+
+		OpenGLStateCache::BindBuffer(GL_PIXCB_UNPACK_BUFFER, 0);
+
+		uint32_t stepCount = TextureCompressor::IsCompressed(m_Specification.Format) ? m_MipCount : m_Height;
+		if (upload.NextStep == stepCount)
+			upload.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+		return issued;
+	}
+
+	void OpenGLTexture2D::StageUploadRange(PendingUpload& upload, uint64_t offset, uint64_t size)
+	{
+		// The mapping is not coherent, the flush is what makes the copy visible to the commands after it
+		memcpy(upload.Mapped + offset, upload.Data.Data + offset, size);
+		glFlushMappedNamedBufferRange(upload.Buffer, offset, size);
+	}
+
+	void OpenGLTexture2D::ReleaseUpload(PendingUpload& upload)
+	{
+		if (upload.Fence)
+			glDeleteSync(upload.Fence);
+
+		glUnmapNamedBuffer(upload.Buffer);
+		OpenGLStateCache::OnBufferDeleted(upload.Buffer);
+		glDeleteBuffers(1, &upload.Buffer);
+
+		upload.Data.Release();
+	}
+
+	void OpenGLTexture2D::UpdateAsyncUploads(uint64_t budget)
+	{
+		if (s_PendingUploads.empty())
+			return;
+
+		CB_PROFILE_FUNCTION();
+
+		uint64_t remaining = budget;
+		for (size_t i = 0; i < s_PendingUploads.size();)
+		{
+			PendingUpload& upload = s_PendingUploads[i];
+			if (upload.Fence)
+			{
+				GLenum result = glClientWaitSync(upload.Fence, 0, 0);
+				if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED)
+				{
+					upload.Texture->m_IsLoaded = true;
+					ReleaseUpload(upload);
+
+					s_PendingUploads.erase(s_PendingUploads.begin() + i);
+					continue;
+				}
+			}
+			else if (remaining > 0)
+			{
+				// A step larger than the whole budget still goes out on its own, so every upload finishes eventually
+				remaining -= std::min(remaining, upload.Texture->IssueUploadSteps(upload, remaining, remaining == budget));
+			}
 
-		glTextureSubImage2D(m_RendererID, 0, 0, 0, m_Width, m_Height, m_DataFormat, GL_UNSIGNED_BYTE, data.Data);
+			i++;
+		}
 	}
 
 	void OpenGLTexture2D::Bind(uint32_t slot) const
 	{
 		CB_PROFILE_FUNCTION();
 
-		glBindTextureUnit(slot, m_RendererID);
+		RenderThread::Submit([this, slot]() { OpenGLStateCache::BindTextureUnit(slot, m_RendererID); });
 	}
 
 }
\ No newline at end of file
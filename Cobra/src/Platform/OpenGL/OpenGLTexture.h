@@ -4,15 +4,31 @@
 
 #include <glad/glad.h>
 
+#include <atomic>
+
 namespace Cobra {
 
 	class OpenGLTexture2D : public Texture2D
 	{
 	private:
+		// Data staged in a pixel unpack buffer, copied to the texture in steps that fit the frame's budget
+		struct PendingUpload
+		{
+			OpenGLTexture2D* Texture = nullptr;
+			Cobra::Buffer Data; // Copied into the mapped buffer a step at a time
+			uint32_t Buffer = 0;
+			uint8_t* Mapped = nullptr;
+			uint32_t NextStep = 0; // Row for uncompressed textures, mip level for compressed ones
+			GLsync Fence = nullptr; // Set once every step is issued
+		};
+
+		static std::vector<PendingUpload> s_PendingUploads;
+
 		TextureSpecification m_Specification;
 
-		bool m_IsLoaded = false;
+		std::atomic<bool> m_IsLoaded = false; // Set on the render thread
 		uint32_t m_Width, m_Height;
+		uint32_t m_MipCount = 1;
 		uint32_t m_RendererID;
 		
 		GLenum m_InternalFormat, m_DataFormat;
@@ -27,6 +43,11 @@ namespace Cobra {
 		uint32_t GetRendererID() const override { return m_RendererID; }
 
 		void SetData(Buffer data) override;
+		void SetDataAsync(Buffer data) override;
+		void SetData(Buffer data, uint32_t x, uint32_t y, uint32_t width, uint32_t height) override;
+		void Clear() override;
+		void CopyFrom(const Texture& source, uint32_t sourceX, uint32_t sourceY, uint32_t width, uint32_t height, uint32_t x, uint32_t y) override;
+		void RegenerateMips() override;
 
 		void Bind(uint32_t slot = 0) const override;
 
@@ -36,6 +57,12 @@ namespace Cobra {
 		{ 
 			return m_RendererID == other.GetRendererID();
 		}
+
+		static void UpdateAsyncUploads(uint64_t budget);
+	private:
+		uint64_t IssueUploadSteps(PendingUpload& upload, uint64_t budget, bool mustProgress);
+		static void StageUploadRange(PendingUpload& upload, uint64_t offset, uint64_t size);
+		static void ReleaseUpload(PendingUpload& upload);
 	};
 
 }
\ No newline at end of file
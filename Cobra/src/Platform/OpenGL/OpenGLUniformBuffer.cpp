@@ -1,6 +1,9 @@
 #include "cbpch.h"
 #include "OpenGLUniformBuffer.h"
 
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
 namespace Cobra {
@@ -9,17 +12,18 @@ namespace Cobra {
 	{
 		glCreateBuffers(1, &m_RendererID);
 		glNamedBufferData(m_RendererID, size, nullptr, GL_DYNAMIC_DRAW); // TODO: investigate usage hint
-		glBindBufferBase(GL_UNIFORM_BUFFER, binding, m_RendererID);
+		OpenGLStateCache::BindUniformBuffer(binding, m_RendererID);
 	}
 
 	OpenGLUniformBuffer::~OpenGLUniformBuffer()
 	{
+		OpenGLStateCache::OnBufferDeleted(m_RendererID);
 		glDeleteBuffers(1, &m_RendererID);
 	}
 
 	void OpenGLUniformBuffer::SetData(const void* data, uint32_t size, uint32_t offset)
 	{
-		glNamedBufferSubData(m_RendererID, offset, size, data);
+		RenderThread::Submit(Buffer(data, size), [this, offset](Buffer data) { glNamedBufferSubData(m_RendererID, offset, data.Size, data.Data); });
 	}
 
 }
\ No newline at end of file
@@ -1,6 +1,9 @@
 #include "cbpch.h"
 #include "OpenGLVertexArray.h"
 
+#include "Cobra/Renderer/RenderThread.h"
+#include "Platform/OpenGL/OpenGLStateCache.h"
+
 #include <glad/glad.h>
 
 namespace Cobra {
@@ -20,6 +23,12 @@ namespace Cobra {
 			case ShaderDataType::Mat3:     return GL_FLOAT;
 			case ShaderDataType::Mat4:     return GL_FLOAT;
 			case ShaderDataType::Bool:     return GL_BOOL;
+			case ShaderDataType::UByte:    return GL_UNSIGNED_BYTE;
+			case ShaderDataType::UByte4:   return GL_UNSIGNED_BYTE;
+			case ShaderDataType::UShort2:  return GL_UNSIGNED_SHORT;
+			case ShaderDataType::UShort4:  return GL_UNSIGNED_SHORT;
+			case ShaderDataType::Half:     return GL_HALF_FLOAT;
+			case ShaderDataType::Half2:    return GL_HALF_FLOAT;
 		}
 
 		CB_CORE_ASSERT(false, "Unknown ShaderDataType!");
@@ -37,6 +46,7 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
+		OpenGLStateCache::OnVertexArrayDeleted(m_RendererID);
 		glDeleteVertexArrays(1, &m_RendererID);
 	}
 
@@ -44,95 +54,125 @@ namespace Cobra {
 	{
 		CB_PROFILE_FUNCTION();
 
-		glBindVertexArray(m_RendererID);
+		RenderThread::Submit([this]() { OpenGLStateCache::BindVertexArray(m_RendererID); });
 	}
 
 	void OpenGLVertexArray::Unbind() const
 	{
 		CB_PROFILE_FUNCTION();
 
-		glBindVertexArray(0);
+		RenderThread::Submit([]() { OpenGLStateCache::BindVertexArray(0); });
 	}
 
-	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer)
+	void OpenGLVertexArray::AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, VertexInputRate inputRate)
 	{
 		CB_PROFILE_FUNCTION();
 		CB_CORE_ASSERT(vertexBuffer->GetLayout().GetElements().size(), "Vertex Buffer has no layout!");
 
-		glBindVertexArray(m_RendererID);
-		vertexBuffer->Bind();
-
-		uint32_t index = 0;
-		const auto& layout = vertexBuffer->GetLayout();
-
-		for (const auto& element : layout)
+		// The CPU side is updated right away, only the GL calls wait for the render thread
+		uint32_t attributeIndex = m_VertexBufferIndex;
+		for (const auto& element : vertexBuffer->GetLayout())
 		{
 			switch (element.Type)
 			{
-			case ShaderDataType::Float:
-			case ShaderDataType::Float2:
-			case ShaderDataType::Float3:
-			case ShaderDataType::Float4:
-			{
-				glEnableVertexAttribArray(m_VertexBufferIndex);
-				glVertexAttribPointer(m_VertexBufferIndex,
-					element.GetComponentCount(),
-					ShaderDataTypeToOpenGLBaseType(element.Type),
-					element.Normalized ? GL_TRUE : GL_FALSE,
-					layout.GetStride(),
-					(const void*)element.Offset);
-				m_VertexBufferIndex++;
-				break;
+				case ShaderDataType::Mat3: m_VertexBufferIndex += 3; break;
+				case ShaderDataType::Mat4: m_VertexBufferIndex += 4; break;
+				case ShaderDataType::None: break;
+				default:                   m_VertexBufferIndex++; break;
 			}
-			case ShaderDataType::Int:
-			case ShaderDataType::Int2:
-			case ShaderDataType::Int3:
-			case ShaderDataType::Int4:
-			case ShaderDataType::Bool:
-			{
-				glEnableVertexAttribArray(m_VertexBufferIndex);
-				glVertexAttribIPointer(m_VertexBufferIndex,
-					element.GetComponentCount(),
-					ShaderDataTypeToOpenGLBaseType(element.Type),
-					layout.GetStride(),
-					(const void*)element.Offset);
-				m_VertexBufferIndex++;
-				break;
-			}
-			case ShaderDataType::Mat3:
-			case ShaderDataType::Mat4:
+		}
+
+		m_VertexBuffers.push_back(vertexBuffer);
+
+		RenderThread::Submit([this, vertexBuffer, inputRate, attributeIndex]() mutable
+		{
+			OpenGLStateCache::BindVertexArray(m_RendererID);
+			vertexBuffer->Bind();
+
+			const auto& layout = vertexBuffer->GetLayout();
+			uint32_t divisor = inputRate == VertexInputRate::PerInstance ? 1 : 0;
+
+			for (const auto& element : layout)
 			{
-				uint8_t count = element.GetComponentCount();
-				for (uint8_t i = 0; i < count; i++)
+				switch (element.Type)
+				{
+				case ShaderDataType::Float:
+				case ShaderDataType::Float2:
+				case ShaderDataType::Float3:
+				case ShaderDataType::Float4:
+				case ShaderDataType::UByte:
+				case ShaderDataType::UByte4:
+				case ShaderDataType::UShort2:
+				case ShaderDataType::UShort4:
+				case ShaderDataType::Half:
+				case ShaderDataType::Half2:
 				{
-					glEnableVertexAttribArray(m_VertexBufferIndex);
-					glVertexAttribPointer(m_VertexBufferIndex,
-						count,
+					glEnableVertexAttribArray(attributeIndex);
+					glVertexAttribPointer(attributeIndex,
+						element.GetComponentCount(),
 						ShaderDataTypeToOpenGLBaseType(element.Type),
 						element.Normalized ? GL_TRUE : GL_FALSE,
 						layout.GetStride(),
-						(const void*)(element.Offset + sizeof(float) * count * i));
-					glVertexAttribDivisor(m_VertexBufferIndex, 1);
-					m_VertexBufferIndex++;
+						(const void*)element.Offset);
+					glVertexAttribDivisor(attributeIndex, divisor);
+					attributeIndex++;
+					break;
+				}
+				case ShaderDataType::Int:
+				case ShaderDataType::Int2:
+				case ShaderDataType::Int3:
+				case ShaderDataType::Int4:
+				case ShaderDataType::Bool:
+				{
+					glEnableVertexAttribArray(attributeIndex);
+					glVertexAttribIPointer(attributeIndex,
+						element.GetComponentCount(),
+						ShaderDataTypeToOpenGLBaseType(element.Type),
+						layout.GetStride(),
+						(const void*)element.Offset);
+					glVertexAttribDivisor(attributeIndex, divisor);
+					attributeIndex++;
+					break;
+				}
+				case ShaderDataType::Mat3:
+				case ShaderDataType::Mat4:
+				{
+					// Each column occupies its own attribute location
+					uint8_t count = element.Type == ShaderDataType::Mat3 ? 3 : 4;
+					for (uint8_t i = 0; i < count; i++)
+					{
+						glEnableVertexAttribArray(attributeIndex);
+						glVertexAttribPointer(attributeIndex,
+							count,
+							ShaderDataTypeToOpenGLBaseType(element.Type),
+							element.Normalized ? GL_TRUE : GL_FALSE,
+							layout.GetStride(),
+							(const void*)(element.Offset + sizeof(float) * count * i));
+						glVertexAttribDivisor(attributeIndex, divisor);
+						attributeIndex++;
+					}
+					break;
+				}
+				case ShaderDataType::None:
+					break; // Padding
+				default:
+					CB_CORE_ASSERT(false, "Unknown ShaderDataType!");
 				}
-				break;
-			}
-			default:
-				CB_CORE_ASSERT(false, "Unknown ShaderDataType!");
 			}
-		}
-
-		m_VertexBuffers.push_back(vertexBuffer);
+		});
 	}
 
 	void OpenGLVertexArray::SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer)
 	{
 		CB_PROFILE_FUNCTION();
 
-		glBindVertexArray(m_RendererID);
-		indexBuffer->Bind();
-
 		m_IndexBuffer = indexBuffer;
+
+		RenderThread::Submit([this, indexBuffer]()
+		{
+			OpenGLStateCache::BindVertexArray(m_RendererID);
+			indexBuffer->Bind();
+		});
 	}
 
 }
\ No newline at end of file
@@ -19,7 +19,7 @@ namespace Cobra {
 		void Bind() const override;
 		void Unbind() const override;
 		
-		void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer) override;
+		void AddVertexBuffer(const Ref<VertexBuffer>& vertexBuffer, VertexInputRate inputRate = VertexInputRate::PerVertex) override;
 		void SetIndexBuffer(const Ref<IndexBuffer>& indexBuffer) override;
 
 		const std::vector<Ref<VertexBuffer>>& GetVertexBuffers() const override { return m_VertexBuffers; }
@@ -5,6 +5,8 @@
 #include "Cobra/Events/MouseEvent.h"
 #include "Cobra/Events/KeyEvent.h"
 
+#include "Cobra/Renderer/RenderThread.h"
+
 #include "Platform/OpenGL/OpenGLContext.h"
 
 namespace Cobra {
@@ -196,17 +198,21 @@ namespace Cobra {
 		CB_PROFILE_FUNCTION();
 
 		glfwPollEvents();
-		m_Context->SwapBuffers();
+		RenderThread::Submit([context = m_Context.get()]() { context->SwapBuffers(); });
 	}
 
 	void WindowsWindow::SetVSync(bool enabled)
 	{
 		CB_PROFILE_FUNCTION();
 
-		if (enabled)
-			glfwSwapInterval(1);
-		else
-			glfwSwapInterval(0);
+		// Applies to the context current on the calling thread
+		RenderThread::Submit([enabled]()
+		{
+			if (enabled)
+				glfwSwapInterval(1);
+			else
+				glfwSwapInterval(0);
+		});
 
 		m_Data.VSync = enabled;
 	}
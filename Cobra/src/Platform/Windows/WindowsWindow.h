@@ -32,6 +32,7 @@ namespace Cobra {
 		inline virtual void Restore() override { glfwRestoreWindow(m_Window); }
 
 		inline void* GetNativeWindow() const override { return m_Window; }
+		inline GraphicsContext* GetContext() const override { return m_Context.get(); }
 	private:
 		virtual void Init(const WindowProps& props);
 		virtual void Shutdown();
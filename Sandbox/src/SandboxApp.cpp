@@ -22,6 +22,7 @@ Cobra::Application* Cobra::CreateApplication(Cobra::ApplicationCommandLineArgs a
 	spec.Name = "Sandbox";
 	//spec.WorkingDirecory = "../Cobra-Editor";
 	spec.CommandLineArgs = args;
+	spec.Renderer.EntityIDs = false;
 
 	return new Sandbox(spec);
 }
\ No newline at end of file